@@ -424,6 +424,13 @@ Returns:
     gDxeCoreImageHandle
     );
 
+  //
+  // Install the DXE core profile table if profiling is enabled in build
+  //
+  CORE_PROFILE_CODE (
+    CoreInitializeProfileTable ();
+  )
+
   DEBUG_CODE (
     DEBUG ((EFI_D_INFO | EFI_D_LOAD, "HOBLIST address in DXE = 0x%x\n", HobStart));
   )
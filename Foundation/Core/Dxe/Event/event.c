@@ -188,6 +188,9 @@ Returns:
 {
   IEVENT          *Event;
   EFI_LIST_ENTRY  *Head;
+  CORE_PROFILE_CODE (
+    UINTN         ProfileIndex;
+  )
   
   CoreAcquireEventLock ();
   ASSERT (gEventQueueLock.OwnerTpl == Priority);
@@ -216,7 +219,17 @@ Returns:
     //
     // Notify this event
     //
+    CORE_PROFILE_CODE (
+      ProfileIndex = CoreProfileStart (
+                       EFI_DXE_CORE_PROFILE_EVENT_NOTIFY,
+                       (EFI_HANDLE) Event,
+                       (UINT64) (UINTN) Event->NotifyFunction
+                       );
+    )
     Event->NotifyFunction (Event, Event->NotifyContext);
+    CORE_PROFILE_CODE (
+      CoreProfileEnd (ProfileIndex, NULL);
+    )
 
     //
     // Check for next pending event
@@ -587,6 +600,9 @@ Returns:
 --*/
 {
   IEVENT          *Event;
+  CORE_PROFILE_CODE (
+    UINT64        StartTick;
+  )
 
   Event = UserEvent;
 
@@ -598,6 +614,10 @@ Returns:
     return EFI_INVALID_PARAMETER;
   }
 
+  CORE_PROFILE_CODE (
+    StartTick = CoreProfileServiceStart ();
+  )
+
   CoreAcquireEventLock ();
 
   //
@@ -626,6 +646,9 @@ Returns:
   }
 
   CoreReleaseEventLock ();
+  CORE_PROFILE_CODE (
+    CoreProfileServiceEnd (EFI_DXE_CORE_PROFILE_SERVICE_SIGNAL_EVENT, StartTick);
+  )
   return EFI_SUCCESS;
 }
 
@@ -737,6 +760,9 @@ Returns:
 {
   EFI_STATUS      Status;
   UINTN           Index;
+  CORE_PROFILE_CODE (
+    UINTN         ProfileIndex;
+  )
 
   //
   // Can only WaitForEvent at TPL_APPLICATION
@@ -745,6 +771,14 @@ Returns:
     return EFI_UNSUPPORTED;
   }
 
+  CORE_PROFILE_CODE (
+    ProfileIndex = CoreProfileStart (
+                     EFI_DXE_CORE_PROFILE_WAIT_FOR_EVENT,
+                     (NumberOfEvents != 0) ? (EFI_HANDLE) UserEvents[0] : NULL,
+                     NumberOfEvents
+                     );
+  )
+
   for(;;) {
       
     for(Index = 0; Index < NumberOfEvents; Index++) {
@@ -756,6 +790,9 @@ Returns:
       //
       if (Status != EFI_NOT_READY) {
         *UserIndex = Index;
+        CORE_PROFILE_CODE (
+          CoreProfileEnd (ProfileIndex, NULL);
+        )
         return Status;
       }
     }
@@ -389,6 +389,9 @@ Returns:
   UINTN                                      SortIndex;
   BOOLEAN                                    OneStarted;
   BOOLEAN                                    DriverFound;
+  CORE_PROFILE_CODE (
+    UINTN                                    ProfileIndex;
+  )
 
   //
   // Initialize local variables
@@ -571,11 +574,21 @@ Returns:
     for (Index = 0; (Index < NumberOfSortedDriverBindingProtocols) && !DriverFound; Index++) {
       if (SortedDriverBindingProtocols[Index] != NULL) {
         DriverBinding = SortedDriverBindingProtocols[Index];
+        CORE_PROFILE_CODE (
+          ProfileIndex = CoreProfileStart (
+                           EFI_DXE_CORE_PROFILE_BINDING_SUPPORTED,
+                           DriverBinding->DriverBindingHandle,
+                           (UINT64) (UINTN) ControllerHandle
+                           );
+        )
         Status = DriverBinding->Supported(
                                   DriverBinding, 
                                   ControllerHandle,
                                   RemainingDevicePath
                                   );
+        CORE_PROFILE_CODE (
+          CoreProfileEnd (ProfileIndex, NULL);
+        )
         if (!EFI_ERROR (Status)) {
           SortedDriverBindingProtocols[Index] = NULL;
           DriverFound = TRUE;
@@ -585,11 +598,21 @@ Returns:
           // on ControllerHandle.
           //
           PERF_START (DriverBinding->DriverBindingHandle, DRIVERBINDING_START_TOK, NULL, 0);
+          CORE_PROFILE_CODE (
+            ProfileIndex = CoreProfileStart (
+                             EFI_DXE_CORE_PROFILE_BINDING_START,
+                             DriverBinding->DriverBindingHandle,
+                             (UINT64) (UINTN) ControllerHandle
+                             );
+          )
           Status = DriverBinding->Start (
                                     DriverBinding, 
                                     ControllerHandle,
                                     RemainingDevicePath
                                     );
+          CORE_PROFILE_CODE (
+            CoreProfileEnd (ProfileIndex, NULL);
+          )
           PERF_END (DriverBinding->DriverBindingHandle, DRIVERBINDING_START_TOK, NULL, 0);
 
           if (!EFI_ERROR (Status)) {
@@ -382,13 +382,26 @@ Returns:
 
 --*/
 {
-  return CoreInstallProtocolInterfaceNotify (
-            UserHandle, 
-            Protocol, 
-            InterfaceType, 
-            Interface, 
-            TRUE
-            );
+  EFI_STATUS  Status;
+  CORE_PROFILE_CODE (
+    UINT64    StartTick;
+
+    StartTick = CoreProfileServiceStart ();
+  )
+
+  Status = CoreInstallProtocolInterfaceNotify (
+             UserHandle, 
+             Protocol, 
+             InterfaceType, 
+             Interface, 
+             TRUE
+             );
+
+  CORE_PROFILE_CODE (
+    CoreProfileServiceEnd (EFI_DXE_CORE_PROFILE_SERVICE_INSTALL_PROTOCOL, StartTick);
+  )
+
+  return Status;
 }
 
 EFI_STATUS
@@ -1118,6 +1131,9 @@ Returns:
   BOOLEAN             Exclusive;
   BOOLEAN             Disconnect;
   BOOLEAN             ExactMatch;
+  CORE_PROFILE_CODE (
+    UINT64            StartTick;
+  )
 
   //
   // Check for invalid Protocol
@@ -1187,6 +1203,10 @@ Returns:
     return EFI_INVALID_PARAMETER;
   }
 
+  CORE_PROFILE_CODE (
+    StartTick = CoreProfileServiceStart ();
+  )
+
   //
   // Lock the protocol database
   //
@@ -1304,6 +1324,9 @@ Done:
   // Done. Release the database lock are return
   //
   CoreReleaseProtocolLock ();
+  CORE_PROFILE_CODE (
+    CoreProfileServiceEnd (EFI_DXE_CORE_PROFILE_SERVICE_OPEN_PROTOCOL, StartTick);
+  )
   return Status;
 }
 
@@ -677,6 +677,9 @@ Returns:
 {
   EFI_STATUS          Status;
   UINTN               BufferSize;
+  CORE_PROFILE_CODE (
+    UINT64            StartTick;
+  )
 
   if (NumberHandles == NULL) {
     return EFI_INVALID_PARAMETER;
@@ -686,6 +689,10 @@ Returns:
     return EFI_INVALID_PARAMETER;
   }
 
+  CORE_PROFILE_CODE (
+    StartTick = CoreProfileServiceStart ();
+  )
+
   BufferSize = 0;
   *NumberHandles = 0;
   *Buffer = NULL;
@@ -707,15 +714,17 @@ Returns:
     case EFI_BUFFER_TOO_SMALL:
       break;
     case EFI_INVALID_PARAMETER:
-      return Status;
+      goto Done;
     default:
-      return EFI_NOT_FOUND;
+      Status = EFI_NOT_FOUND;
+      goto Done;
     }
   }
 
   *Buffer = CoreAllocateBootServicesPool (BufferSize);
   if (*Buffer == NULL) {
-    return EFI_OUT_OF_RESOURCES;
+    Status = EFI_OUT_OF_RESOURCES;
+    goto Done;
   }
 
   Status = CoreLocateHandle (
@@ -731,6 +740,10 @@ Returns:
     *NumberHandles = 0;
   }
 
+Done:
+  CORE_PROFILE_CODE (
+    CoreProfileServiceEnd (EFI_DXE_CORE_PROFILE_SERVICE_LOCATE_HANDLE_BUFFER, StartTick);
+  )
   return Status;
 }
 
@@ -958,8 +958,14 @@ Returns:
 --*/
 {
   EFI_STATUS    Status;
+  CORE_PROFILE_CODE (
+    UINTN       ProfileIndex;
+  )
 
   PERF_START (NULL, L"LoadImage", NULL, 0);
+  CORE_PROFILE_CODE (
+    ProfileIndex = CoreProfileStart (EFI_DXE_CORE_PROFILE_LOAD_IMAGE, NULL, (UINT64) (UINTN) ParentImageHandle);
+  )
 
   Status = CoreLoadImageCommon (
              BootPolicy,
@@ -975,6 +981,10 @@ Returns:
              FALSE
              );
 
+  CORE_PROFILE_CODE (
+    CoreProfileEnd (ProfileIndex, EFI_ERROR (Status) ? NULL : *ImageHandle);
+  )
+
   if (!EFI_ERROR (Status)) {
     PERF_UPDATE (0, L"LoadImage", NULL, *ImageHandle, L"LoadImage", NULL);
     PERF_END (*ImageHandle, L"LoadImage", NULL, 0);
@@ -1088,6 +1098,9 @@ Returns:
   LOADED_IMAGE_PRIVATE_DATA     *Image;
   LOADED_IMAGE_PRIVATE_DATA     *LastImage;  
   UINT64                        HandleDatabaseKey;
+  CORE_PROFILE_CODE (
+    UINTN                       ProfileIndex;
+  )
 
   Image = CoreLoadedImageInfo (ImageHandle);
   if (Image == NULL_HANDLE  ||  Image->Started) {
@@ -1105,6 +1118,9 @@ Returns:
   // Don't profile Objects or invalid start requests
   //
   PERF_START (ImageHandle, START_IMAGE_TOK, NULL, 0);
+  CORE_PROFILE_CODE (
+    ProfileIndex = CoreProfileStart (EFI_DXE_CORE_PROFILE_START_IMAGE, ImageHandle, 0);
+  )
 
   //
   // Push the current start image context, and
@@ -1122,6 +1138,9 @@ Returns:
   Image->JumpContext = CoreAllocateBootServicesPool (gEfiPeiTransferControl->JumpContextSize);
   if (Image->JumpContext == NULL) {
     PERF_END (ImageHandle, START_IMAGE_TOK, NULL, 0);
+    CORE_PROFILE_CODE (
+      CoreProfileEnd (ProfileIndex, NULL);
+    )
     return EFI_OUT_OF_RESOURCES;
   }
 
@@ -1224,6 +1243,9 @@ Returns:
   // Done
   //
   PERF_END (ImageHandle, START_IMAGE_TOK, NULL, 0);
+  CORE_PROFILE_CODE (
+    CoreProfileEnd (ProfileIndex, NULL);
+  )
   return Status;
 }
 
@@ -62,6 +62,7 @@ Revision History
 #include "Peihob.h"
 #include "EfiHobLib.h"
 #include "DebugMask.h"
+#include "Profile.h"
 
 
 typedef struct {
@@ -1131,6 +1131,9 @@ Returns:
   UINT64          Start;
   UINT64          MaxAddress;
   UINTN           Alignment;
+  CORE_PROFILE_CODE (
+    UINT64        StartTick;
+  )
 
   if (Type < AllocateAnyPages || Type >= (UINTN) MaxAllocateType) {
     return EFI_INVALID_PARAMETER;
@@ -1174,6 +1177,10 @@ Returns:
     MaxAddress = Start;
   }
 
+  CORE_PROFILE_CODE (
+    StartTick = CoreProfileServiceStart ();
+  )
+
   CoreAcquireMemoryLock ();
   
   //
@@ -1199,6 +1206,10 @@ Done:
     *Memory = Start;
   }
 
+  CORE_PROFILE_CODE (
+    CoreProfileServiceEnd (EFI_DXE_CORE_PROFILE_SERVICE_ALLOCATE_PAGES, StartTick);
+  )
+
   return Status;
 }
 
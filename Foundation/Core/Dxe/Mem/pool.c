@@ -210,6 +210,9 @@ Returns:
 --*/
 {
   EFI_STATUS    Status;
+  CORE_PROFILE_CODE (
+    UINT64      StartTick;
+  )
 
   //
   // If it's not a valid type, fail it
@@ -230,6 +233,10 @@ Returns:
     return EFI_OUT_OF_RESOURCES;
   }
 
+  CORE_PROFILE_CODE (
+    StartTick = CoreProfileServiceStart ();
+  )
+
   //
   // Acquire the memory lock and make the allocation
   //
@@ -240,6 +247,9 @@ Returns:
 
   *Buffer = CoreAllocatePoolI (PoolType, Size);
   CoreReleaseMemoryLock ();
+  CORE_PROFILE_CODE (
+    CoreProfileServiceEnd (EFI_DXE_CORE_PROFILE_SERVICE_ALLOCATE_POOL, StartTick);
+  )
   return (*Buffer != NULL) ? EFI_SUCCESS : EFI_OUT_OF_RESOURCES;
 }
 
@@ -0,0 +1,297 @@
+/*++
+
+Copyright (c) 2004 - 2007, Intel Corporation                                                         
+All rights reserved. This program and the accompanying materials                          
+are licensed and made available under the terms and conditions of the BSD License         
+which accompanies this distribution.  The full text of the license may be found at        
+http://opensource.org/licenses/bsd-license.php                                            
+                                                                                          
+THE PROGRAM IS DISTRIBUTED UNDER THE BSD LICENSE ON AN "AS IS" BASIS,                     
+WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.             
+
+Module Name:
+
+  Profile.c
+    
+Abstract:
+
+  DXE core profile table. Records are preallocated in a single configuration
+  table, so taking a sample costs two timer reads and a slot reservation and
+  never allocates memory. The busiest boot services are not recorded one by
+  one; they only accumulate a call count and total ticks in the table header.
+
+--*/
+
+#include "Tiano.h"
+#include "DxeCore.h"
+
+#ifdef EFI_DXE_CORE_PROFILE
+
+STATIC EFI_DXE_CORE_PROFILE_TABLE  *mProfileTable = NULL;
+STATIC BOOLEAN                     mTimerPeriodQueried = FALSE;
+
+STATIC
+UINT64
+CoreProfileTimer (
+  VOID
+  )
+/*++
+
+Routine Description:
+
+  Read timer 0 of the CPU architectural protocol. The first successful read
+  also stores the timer period in the profile table, so ticks and period
+  always come from the same timer.
+
+Arguments:
+  None
+
+Returns:
+
+  Current tick, or 0 if the CPU architectural protocol is not installed yet
+  or has no timer.
+
+--*/
+{
+  UINT64  Value;
+  UINT64  Period;
+
+  if (gCpu == NULL) {
+    return 0;
+  }
+
+  if (!mTimerPeriodQueried) {
+    mTimerPeriodQueried = TRUE;
+    if (!EFI_ERROR (gCpu->GetTimerValue (gCpu, 0, &Value, &Period))) {
+      mProfileTable->TimerPeriod = Period;
+    }
+  }
+
+  if (mProfileTable->TimerPeriod == 0) {
+    return 0;
+  }
+
+  if (EFI_ERROR (gCpu->GetTimerValue (gCpu, 0, &Value, NULL))) {
+    return 0;
+  }
+
+  return Value;
+}
+
+VOID
+CoreInitializeProfileTable (
+  VOID
+  )
+/*++
+
+Routine Description:
+
+  Allocate the profile table and install it as a configuration table.
+
+Arguments:
+  None
+
+Returns:
+  NA
+
+--*/
+{
+  EFI_STATUS                  Status;
+  EFI_DXE_CORE_PROFILE_TABLE  *Table;
+
+  Table = CoreAllocateZeroBootServicesPool (
+            sizeof (EFI_DXE_CORE_PROFILE_TABLE) +
+            (CORE_PROFILE_MAX_RECORDS - 1) * sizeof (EFI_DXE_CORE_PROFILE_RECORD)
+            );
+  if (Table == NULL) {
+    return;
+  }
+
+  Table->Signature  = EFI_DXE_CORE_PROFILE_SIGNATURE;
+  Table->Revision   = EFI_DXE_CORE_PROFILE_REVISION;
+  Table->RecordSize = sizeof (EFI_DXE_CORE_PROFILE_RECORD);
+  Table->MaxCount   = CORE_PROFILE_MAX_RECORDS;
+
+  Status = CoreInstallConfigurationTable (&gEfiDxeCoreProfileTableGuid, Table);
+  if (EFI_ERROR (Status)) {
+    CoreFreePool (Table);
+    return;
+  }
+
+  mProfileTable = Table;
+}
+
+UINTN
+CoreProfileStart (
+  IN UINT32      Type,
+  IN EFI_HANDLE  Handle,
+  IN UINT64      Data
+  )
+/*++
+
+Routine Description:
+
+  Append a profile record and stamp its start time.
+
+Arguments:
+
+  Type    - EFI_DXE_CORE_PROFILE_* record type
+  Handle  - Handle the record is charged to
+  Data    - Type specific data
+
+Returns:
+
+  Index of the record to pass to CoreProfileEnd (), or CORE_PROFILE_NO_RECORD
+  if the table is not available or is full.
+
+--*/
+{
+  EFI_DXE_CORE_PROFILE_RECORD *Record;
+  EFI_TPL                     OldTpl;
+  UINTN                       Index;
+
+  if (mProfileTable == NULL) {
+    return CORE_PROFILE_NO_RECORD;
+  }
+
+  //
+  // Event notifications may nest inside any other record, so the slot is
+  // reserved with interrupts off.
+  //
+  OldTpl = CoreRaiseTpl (EFI_TPL_HIGH_LEVEL);
+  Index  = mProfileTable->Count;
+  if (Index >= mProfileTable->MaxCount) {
+    mProfileTable->Dropped++;
+    CoreRestoreTpl (OldTpl);
+    return CORE_PROFILE_NO_RECORD;
+  }
+  mProfileTable->Count = (UINT32) (Index + 1);
+  CoreRestoreTpl (OldTpl);
+
+  Record          = &mProfileTable->Record[Index];
+  Record->Type    = Type;
+  Record->Handle  = (EFI_PHYSICAL_ADDRESS) (UINTN) Handle;
+  Record->Data    = Data;
+  Record->StartTick = CoreProfileTimer ();
+
+  return Index;
+}
+
+VOID
+CoreProfileEnd (
+  IN UINTN       Index,
+  IN EFI_HANDLE  Handle  OPTIONAL
+  )
+/*++
+
+Routine Description:
+
+  Stamp the end time of a profile record. A record that was started before
+  the CPU timer was available is left untimed.
+
+Arguments:
+
+  Index   - Value returned by CoreProfileStart ()
+  Handle  - If not NULL, replaces the handle the record is charged to
+
+Returns:
+
+  NA
+
+--*/
+{
+  EFI_DXE_CORE_PROFILE_RECORD *Record;
+
+  if ((mProfileTable == NULL) || (Index >= mProfileTable->Count)) {
+    return;
+  }
+
+  Record = &mProfileTable->Record[Index];
+  if (Record->StartTick != 0) {
+    Record->EndTick = CoreProfileTimer ();
+  }
+  if (Handle != NULL) {
+    Record->Handle = (EFI_PHYSICAL_ADDRESS) (UINTN) Handle;
+  }
+}
+
+
+UINT64
+CoreProfileServiceStart (
+  VOID
+  )
+/*++
+
+Routine Description:
+
+  Read the start tick of a boot service call that is counted in the
+  service statistics of the profile table.
+
+Arguments:
+  None
+
+Returns:
+
+  Start tick to pass to CoreProfileServiceEnd (), or 0 if the table or the
+  CPU timer is not available.
+
+--*/
+{
+  if (mProfileTable == NULL) {
+    return 0;
+  }
+
+  return CoreProfileTimer ();
+}
+
+VOID
+CoreProfileServiceEnd (
+  IN UINTN   Service,
+  IN UINT64  StartTick
+  )
+/*++
+
+Routine Description:
+
+  Charge one call and the ticks elapsed since StartTick to a boot service.
+
+Arguments:
+
+  Service    - EFI_DXE_CORE_PROFILE_SERVICE_* index
+  StartTick  - Value returned by CoreProfileServiceStart ()
+
+Returns:
+
+  NA
+
+--*/
+{
+  EFI_DXE_CORE_PROFILE_SERVICE_STAT *Stat;
+  EFI_TPL                           OldTpl;
+  UINT64                            EndTick;
+
+  //
+  // A zero start tick means the table was installed during the call, or
+  // there was no CPU timer to read yet.
+  //
+  if ((mProfileTable == NULL) || (StartTick == 0)) {
+    return;
+  }
+
+  EndTick = CoreProfileTimer ();
+  if (EndTick == 0) {
+    return;
+  }
+
+  //
+  // SignalEvent () may be called from the timer interrupt, so the counters
+  // are updated with interrupts off.
+  //
+  Stat   = &mProfileTable->Service[Service];
+  OldTpl = CoreRaiseTpl (EFI_TPL_HIGH_LEVEL);
+  Stat->Calls++;
+  Stat->Ticks += EndTick - StartTick;
+  CoreRestoreTpl (OldTpl);
+}
+
+#endif
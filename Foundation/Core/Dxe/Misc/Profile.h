@@ -0,0 +1,150 @@
+/*++
+
+Copyright (c) 2004 - 2007, Intel Corporation                                                         
+All rights reserved. This program and the accompanying materials                          
+are licensed and made available under the terms and conditions of the BSD License         
+which accompanies this distribution.  The full text of the license may be found at        
+http://opensource.org/licenses/bsd-license.php                                            
+                                                                                          
+THE PROGRAM IS DISTRIBUTED UNDER THE BSD LICENSE ON AN "AS IS" BASIS,                     
+WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.             
+
+Module Name:
+
+  Profile.h
+    
+Abstract:
+
+  Support functions for the DXE core profile table. Built in only when
+  EFI_DXE_CORE_PROFILE is defined.
+
+--*/
+
+#ifndef __DXE_CORE_PROFILE_H__
+#define __DXE_CORE_PROFILE_H__
+
+#include EFI_GUID_DEFINITION (DxeCoreProfile)
+
+#define CORE_PROFILE_MAX_RECORDS  8192
+#define CORE_PROFILE_NO_RECORD    ((UINTN) -1)
+
+#ifdef EFI_DXE_CORE_PROFILE
+#define CORE_PROFILE_CODE(code) code
+#else
+#define CORE_PROFILE_CODE(code)
+#endif
+
+VOID
+CoreInitializeProfileTable (
+  VOID
+  )
+/*++
+
+Routine Description:
+
+  Allocate the profile table and install it as a configuration table.
+
+Arguments:
+  None
+
+Returns:
+  NA
+
+--*/
+;
+
+UINTN
+CoreProfileStart (
+  IN UINT32      Type,
+  IN EFI_HANDLE  Handle,
+  IN UINT64      Data
+  )
+/*++
+
+Routine Description:
+
+  Append a profile record and stamp its start time.
+
+Arguments:
+
+  Type    - EFI_DXE_CORE_PROFILE_* record type
+  Handle  - Handle the record is charged to
+  Data    - Type specific data
+
+Returns:
+
+  Index of the record to pass to CoreProfileEnd (), or CORE_PROFILE_NO_RECORD
+  if the table is not available or is full.
+
+--*/
+;
+
+VOID
+CoreProfileEnd (
+  IN UINTN       Index,
+  IN EFI_HANDLE  Handle  OPTIONAL
+  )
+/*++
+
+Routine Description:
+
+  Stamp the end time of a profile record.
+
+Arguments:
+
+  Index   - Value returned by CoreProfileStart ()
+  Handle  - If not NULL, replaces the handle the record is charged to
+
+Returns:
+
+  NA
+
+--*/
+;
+
+UINT64
+CoreProfileServiceStart (
+  VOID
+  )
+/*++
+
+Routine Description:
+
+  Read the start tick of a boot service call that is counted in the
+  service statistics of the profile table.
+
+Arguments:
+  None
+
+Returns:
+
+  Start tick to pass to CoreProfileServiceEnd (), or 0 if the table is not
+  available.
+
+--*/
+;
+
+VOID
+CoreProfileServiceEnd (
+  IN UINTN   Service,
+  IN UINT64  StartTick
+  )
+/*++
+
+Routine Description:
+
+  Charge one call and the ticks elapsed since StartTick to a boot service.
+
+Arguments:
+
+  Service    - EFI_DXE_CORE_PROFILE_SERVICE_* index
+  StartTick  - Value returned by CoreProfileServiceStart ()
+
+Returns:
+
+  NA
+
+--*/
+;
+
+#endif
@@ -53,6 +53,9 @@ Returns:
 {
   UINT32  Counter;
   UINTN   Remainder;
+  CORE_PROFILE_CODE (
+    UINTN ProfileIndex;
+  )
 
   if (gMetronome == NULL) {
     return EFI_NOT_AVAILABLE_YET;
@@ -73,7 +76,13 @@ Returns:
     Counter++;
   }
 
+  CORE_PROFILE_CODE (
+    ProfileIndex = CoreProfileStart (EFI_DXE_CORE_PROFILE_STALL, NULL, Microseconds);
+  )
   gMetronome->WaitForTick (gMetronome, Counter);
+  CORE_PROFILE_CODE (
+    CoreProfileEnd (ProfileIndex, NULL);
+  )
 
   return EFI_SUCCESS;
 }
@@ -415,12 +415,32 @@ Returns:
 --*/
 {
   PEI_CORE_INSTANCE *PrivateData;
+  EFI_STATUS        Status;
+  UINTN             Index;
 
   PrivateData = PEI_CORE_INSTANCE_FROM_PS_THIS (PeiServices);
 
   if (OldCoreData == NULL) {
     PrivateData->DispatchData.CurrentFvAddress = (EFI_FIRMWARE_VOLUME_HEADER *) PeiStartupDescriptor->BootFirmwareVolume;
     PrivateData->DispatchData.BootFvAddress = (EFI_FIRMWARE_VOLUME_HEADER *) PeiStartupDescriptor->BootFirmwareVolume;    
+
+    //
+    // The depex cache lives in the HOB heap, it is relocated together with
+    // the HOB list when permanent memory is installed. Without it the depex
+    // is simply evaluated on every pass.
+    //
+    Status = PeiAllocatePool (
+               PeiServices,
+               PEI_CORE_MAX_PEIM * sizeof (PEI_DEPEX_CACHE_ENTRY),
+               (VOID **) &PrivateData->DispatchData.DepexCache
+               );
+    if (EFI_ERROR (Status)) {
+      PrivateData->DispatchData.DepexCache = NULL;
+    } else {
+      for (Index = 0; Index < PEI_CORE_MAX_PEIM; Index++) {
+        PrivateData->DispatchData.DepexCache[Index].PeimAddress = NULL;
+      }
+    }
   } else {
     
     //
@@ -507,6 +527,12 @@ Routine Description:
   This routine parses the Dependency Expression, if available, and
   decides if the module can be executed.
 
+  The depex section of each PEIM is located once and remembered in the
+  dispatcher's depex cache. A depex that evaluated to FALSE is only evaluated
+  again after a PPI has been installed or reinstalled, since a dependency 
+  expression can only reference PPIs. If the cache entry does not belong to the PEIM under
+  investigation the depex is located and evaluated from scratch.
+
 Arguments:
   PeiServices - The PEI Service Table
   CurrentPeimAddress - Address of the PEIM Firmware File under investigation
@@ -517,20 +543,48 @@ Returns:
 
 --*/
 {
-  EFI_STATUS  Status;
-  INT8        *DepexData;
-  BOOLEAN     Runnable;
-
-  Status = PeiFfsFindSectionData (
-            PeiServices,
-            EFI_SECTION_PEI_DEPEX,
-            CurrentPeimAddress,
-            &DepexData 
-            );
+  EFI_STATUS              Status;
+  INT8                    *DepexData;
+  BOOLEAN                 Runnable;
+  PEI_CORE_INSTANCE       *PrivateData;
+  PEI_DEPEX_CACHE_ENTRY   *CacheEntry;
+
+  PrivateData = PEI_CORE_INSTANCE_FROM_PS_THIS (PeiServices);
+  CacheEntry  = NULL;
+  if ((PrivateData->DispatchData.DepexCache != NULL) &&
+      (PrivateData->DispatchData.CurrentPeim < PEI_CORE_MAX_PEIM)) {
+    CacheEntry = &PrivateData->DispatchData.DepexCache[PrivateData->DispatchData.CurrentPeim];
+  }
+
+  if ((CacheEntry != NULL) && (CacheEntry->PeimAddress == CurrentPeimAddress)) {
+    //
+    // Nothing has been installed since the depex last failed, so it still fails.
+    //
+    if (CacheEntry->PpiGeneration == PrivateData->PpiData.Generation) {
+      return FALSE;
+    }
+    DepexData = CacheEntry->DepexData;
+  } else {
+    Status = PeiFfsFindSectionData (
+              PeiServices,
+              EFI_SECTION_PEI_DEPEX,
+              CurrentPeimAddress,
+              &DepexData 
+              );
+    if (EFI_ERROR (Status)) {
+      DepexData = NULL;
+    }
+    if (CacheEntry != NULL) {
+      CacheEntry->PeimAddress = (EFI_FFS_FILE_HEADER *) CurrentPeimAddress;
+      CacheEntry->DepexData   = DepexData;
+      CacheEntry->PpiGeneration = -1;
+    }
+  }
+
   //
   // If there is no DEPEX, assume the module can be executed
   //
-  if (EFI_ERROR (Status)) {
+  if (DepexData == NULL) {
     return TRUE;
   }
 
@@ -543,6 +597,10 @@ Returns:
             &Runnable  
             );
 
+  if ((CacheEntry != NULL) && !Runnable) {
+    CacheEntry->PpiGeneration = PrivateData->PpiData.Generation;
+  }
+
   return Runnable;
 }
 
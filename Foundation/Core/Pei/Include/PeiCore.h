@@ -69,9 +69,32 @@ typedef struct {
   INTN                    DispatchListEnd;
   INTN                    LastDispatchedInstall;
   INTN                    LastDispatchedNotify;
+  //
+  // Bumped whenever a PPI is installed or reinstalled
+  //
+  INTN                    Generation;
   PEI_PPI_LIST_POINTERS   PpiListPtrs[MAX_PPI_DESCRIPTORS];
 } PEI_PPI_DATABASE;
 
+//
+// The dispatched PEIM bitmap is a UINT64, so at most 64 PEIMs are tracked.
+//
+#define PEI_CORE_MAX_PEIM   64
+
+//
+// Per-PEIM dependency expression cache. The depex section of a PEIM is
+// located only once, and a depex that evaluated to FALSE is not evaluated
+// again until a PPI has been installed or reinstalled. The PEIM file header
+// is kept so that a stale entry (a different file found at the same index)
+// is detected and the depex is re-evaluated dynamically. The cache is
+// allocated from the PEI heap, not the CAR stack.
+//
+typedef struct {
+  EFI_FFS_FILE_HEADER         *PeimAddress;
+  INT8                        *DepexData;
+  INTN                        PpiGeneration;
+} PEI_DEPEX_CACHE_ENTRY;
+
 typedef struct {
   UINT8                       CurrentPeim;
   UINT8                       CurrentFv;
@@ -81,6 +104,7 @@ typedef struct {
   EFI_FIRMWARE_VOLUME_HEADER  *CurrentFvAddress;
   EFI_FIRMWARE_VOLUME_HEADER  *BootFvAddress;
   EFI_FIND_FV_PPI             *FindFv;
+  PEI_DEPEX_CACHE_ENTRY       *DepexCache;
 } PEI_CORE_DISPATCH_DATA;
 
 
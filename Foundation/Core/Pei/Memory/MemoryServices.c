@@ -175,6 +175,11 @@ Returns:
 
   ConvertPpiPointers (PeiServices, OldHandOffHob, NewHandOffHob);
 
+  if (PrivateData->DispatchData.DepexCache != NULL) {
+    PrivateData->DispatchData.DepexCache = (PEI_DEPEX_CACHE_ENTRY *) ((UINTN) PrivateData->DispatchData.DepexCache + 
+                                           (UINTN) NewHandOffHob - (UINTN) OldHandOffHob);
+  }
+
   PeiBuildHobStack (PeiServices, PrivateData->StackBase, PrivateData->StackSize);
 
   PEI_DEBUG_CODE (
@@ -220,6 +220,8 @@ Returns:
     Index++;
   }
 
+  PrivateData->PpiData.Generation++;
+
   //
   // Dispatch any callback level notifies for newly installed PPIs.
   //
@@ -297,6 +299,7 @@ Returns:
   // 
   PEI_DEBUG((PeiServices, EFI_D_INFO, "Reinstall PPI: %g\n", NewPpi->Guid));
   PrivateData->PpiData.PpiListPtrs[Index].Ppi = NewPpi;
+  PrivateData->PpiData.Generation++;
 
   //
   // Dispatch any callback level notifies for the newly installed PPI.
@@ -0,0 +1,28 @@
+/*++
+
+Copyright (c) 2004, Intel Corporation                                                         
+All rights reserved. This program and the accompanying materials                          
+are licensed and made available under the terms and conditions of the BSD License         
+which accompanies this distribution.  The full text of the license may be found at        
+http://opensource.org/licenses/bsd-license.php                                            
+                                                                                          
+THE PROGRAM IS DISTRIBUTED UNDER THE BSD LICENSE ON AN "AS IS" BASIS,                     
+WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.             
+
+Module Name:
+  
+    DxeCoreProfile.c
+    
+Abstract:
+
+  The GUID of the DXE core profile configuration table.
+
+--*/
+
+#include "Tiano.h"
+#include EFI_GUID_DEFINITION (DxeCoreProfile)
+
+EFI_GUID  gEfiDxeCoreProfileTableGuid  = EFI_DXE_CORE_PROFILE_TABLE_GUID;
+
+EFI_GUID_STRING (&gEfiDxeCoreProfileTableGuid, "DXE Core Profile Table",
+                 "Guid for DXE Core Profile Configuration Table");
@@ -0,0 +1,103 @@
+/*++
+
+Copyright (c) 2004, Intel Corporation                                                         
+All rights reserved. This program and the accompanying materials                          
+are licensed and made available under the terms and conditions of the BSD License         
+which accompanies this distribution.  The full text of the license may be found at        
+http://opensource.org/licenses/bsd-license.php                                            
+                                                                                          
+THE PROGRAM IS DISTRIBUTED UNDER THE BSD LICENSE ON AN "AS IS" BASIS,                     
+WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.             
+
+Module Name:
+  
+    DxeCoreProfile.h
+    
+Abstract:
+  The DXE core profile configuration table definition. The table is installed
+  by a DXE core built with EFI_DXE_CORE_PROFILE and holds one timestamped
+  record per image load/start, driver binding Supported ()/Start () call,
+  WaitForEvent (), Stall () and event notification, plus call counts and
+  total time for the most frequently used boot services.
+
+--*/
+
+#ifndef _DXE_CORE_PROFILE_GUID_H_
+#define _DXE_CORE_PROFILE_GUID_H_
+
+#define EFI_DXE_CORE_PROFILE_TABLE_GUID  \
+{0x0210cf96, 0x8dde, 0x46a6, 0xa0, 0x32, 0xf8, 0xc5, 0xa5, 0x9d, 0x8f, 0xdb}
+
+#define EFI_DXE_CORE_PROFILE_SIGNATURE  EFI_SIGNATURE_32 ('D', 'X', 'P', 'F')
+#define EFI_DXE_CORE_PROFILE_REVISION   0x00010001
+
+//
+// Record types. Handle and Data hold:
+//   LOAD_IMAGE         - new image handle,           parent image handle
+//   START_IMAGE        - image handle,               0
+//   BINDING_SUPPORTED  - driver binding handle,      controller handle
+//   BINDING_START      - driver binding handle,      controller handle
+//   WAIT_FOR_EVENT     - first event waited on,      number of events
+//   STALL              - 0,                          microseconds requested
+//   EVENT_NOTIFY       - event,                      notification function
+//
+#define EFI_DXE_CORE_PROFILE_LOAD_IMAGE         1
+#define EFI_DXE_CORE_PROFILE_START_IMAGE        2
+#define EFI_DXE_CORE_PROFILE_BINDING_SUPPORTED  3
+#define EFI_DXE_CORE_PROFILE_BINDING_START      4
+#define EFI_DXE_CORE_PROFILE_WAIT_FOR_EVENT     5
+#define EFI_DXE_CORE_PROFILE_STALL              6
+#define EFI_DXE_CORE_PROFILE_EVENT_NOTIFY       7
+
+//
+// Boot services that are too frequent to record one by one. Each of them
+// only accumulates a call count and the total ticks spent inside it, which
+// is enough to derive a cost per call. Ticks are inclusive, so a service
+// that calls another one (for example InstallProtocolInterface () calling
+// AllocatePool ()) is charged for both.
+//
+#define EFI_DXE_CORE_PROFILE_SERVICE_ALLOCATE_POOL        0
+#define EFI_DXE_CORE_PROFILE_SERVICE_ALLOCATE_PAGES       1
+#define EFI_DXE_CORE_PROFILE_SERVICE_INSTALL_PROTOCOL     2
+#define EFI_DXE_CORE_PROFILE_SERVICE_OPEN_PROTOCOL        3
+#define EFI_DXE_CORE_PROFILE_SERVICE_LOCATE_HANDLE_BUFFER 4
+#define EFI_DXE_CORE_PROFILE_SERVICE_SIGNAL_EVENT         5
+#define EFI_DXE_CORE_PROFILE_SERVICE_MAX                  6
+
+typedef struct {
+  UINT64                      Calls;
+  UINT64                      Ticks;
+} EFI_DXE_CORE_PROFILE_SERVICE_STAT;
+
+typedef struct {
+  UINT32                      Type;
+  UINT32                      Reserved;
+  EFI_PHYSICAL_ADDRESS        Handle;
+  UINT64                      Data;
+  UINT64                      StartTick;
+  UINT64                      EndTick;
+} EFI_DXE_CORE_PROFILE_RECORD;
+
+//
+// Records are appended in start order; EndTick is 0 while a record is open.
+// Dropped counts records that did not fit once MaxCount was reached.
+// Ticks are read from timer 0 of the CPU architectural protocol, and
+// TimerPeriod is the length of one of its ticks in femtoseconds. Records
+// started before that protocol was installed have StartTick 0 and are not
+// timed.
+//
+typedef struct {
+  UINT32                            Signature;
+  UINT32                            Revision;
+  UINT32                            RecordSize;
+  UINT32                            MaxCount;
+  UINT32                            Count;
+  UINT32                            Dropped;
+  UINT64                            TimerPeriod;
+  EFI_DXE_CORE_PROFILE_SERVICE_STAT Service[EFI_DXE_CORE_PROFILE_SERVICE_MAX];
+  EFI_DXE_CORE_PROFILE_RECORD       Record[1];
+} EFI_DXE_CORE_PROFILE_TABLE;
+
+extern EFI_GUID gEfiDxeCoreProfileTableGuid;
+
+#endif
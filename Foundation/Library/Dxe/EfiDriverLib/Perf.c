@@ -25,7 +25,6 @@ Abstract:
 #include EFI_PROTOCOL_DEFINITION (LoadedImage)
 #include EFI_GUID_DEFINITION (Hob)
 #include EFI_GUID_DEFINITION (PeiPerformanceHob)
-#include "linkedlist.h"
 #include "EfiHobLib.h"
 #include "EfiImage.h"
 
@@ -43,17 +42,27 @@ GetPeiPerformance (
 
 #define EFI_PERFORMANCE_DATA_SIGNATURE  EFI_SIGNATURE_32 ('P', 'E', 'D', 'A')
 
+//
+// Gauge records live in fixed-size chunks that are never moved or freed, so
+// a pointer handed out by GetGauge () stays valid. A record is reserved by
+// bumping mPerfDataCount and becomes visible to readers once its Signature
+// has been written.
+//
+#define EFI_PERF_DATA_CHUNK_SIZE  256
+#define EFI_PERF_DATA_MAX_CHUNKS  64
+#define EFI_PERF_DATA_MAX_COUNT   (EFI_PERF_DATA_CHUNK_SIZE * EFI_PERF_DATA_MAX_CHUNKS)
+
 typedef struct {
   UINT32          Signature;
-  EFI_LIST_ENTRY  Link;
+  UINT32          Index;
   EFI_GAUGE_DATA  GaugeData;
-} EFI_PERF_DATA_LIST;
-
-#define GAUGE_DATA_FROM_LINK(_link)  \
-            CR(_link, EFI_PERF_DATA_LIST, Link, EFI_PERFORMANCE_DATA_SIGNATURE)
+} EFI_PERF_DATA_RECORD;
 
 #define GAUGE_DATA_FROM_GAUGE(_GaugeData)  \
-            CR(_GaugeData, EFI_PERF_DATA_LIST, GaugeData, EFI_PERFORMANCE_DATA_SIGNATURE)
+            CR(_GaugeData, EFI_PERF_DATA_RECORD, GaugeData, EFI_PERFORMANCE_DATA_SIGNATURE)
+
+#define PERF_DATA_RECORD(_Index)  \
+            (&mPerfDataChunk[(_Index) / EFI_PERF_DATA_CHUNK_SIZE][(_Index) % EFI_PERF_DATA_CHUNK_SIZE])
 
 #define EFI_PERFORMANCE_SIGNATURE         EFI_SIGNATURE_32 ('P', 'E', 'R', 'F')
 
@@ -74,7 +83,19 @@ typedef struct {
 #define EFI_PERFORMANCE_FROM_THIS(a) \
   CR(a, EFI_PERFORMANCE_INSTANCE, Perf, EFI_PERFORMANCE_SIGNATURE)
 
-EFI_LIST_ENTRY  mPerfDataHead = INITIALIZE_LIST_HEAD_VARIABLE(mPerfDataHead);
+STATIC EFI_PERF_DATA_RECORD     *mPerfDataChunk[EFI_PERF_DATA_MAX_CHUNKS];
+STATIC UINTN                    mPerfDataCount = 0;
+
+//
+// Every published record below this index has been ended, so EndGauge ()
+// starts its oldest-first search here.
+//
+STATIC UINTN                    mPerfDataOpenIndex = 0;
+
+//
+// Cached performance protocol of the module calling StartMeasure ()/EndMeasure ()
+//
+STATIC EFI_PERFORMANCE_PROTOCOL *mPerformance = NULL;
 
 STATIC
 VOID
@@ -271,7 +292,59 @@ GetNameFromHandle (
   return ;
 }
 
-EFI_PERF_DATA_LIST *
+STATIC
+EFI_PERF_DATA_RECORD *
+ReserveDataRecord (
+  VOID
+  )
+/*++
+
+Routine Description:
+
+  Reserve the next free gauge record. The reservation itself is a counter
+  increment at EFI_TPL_HIGH_LEVEL, so it is safe against callers at any TPL.
+  When the last record of a chunk is handed out the next chunk is allocated,
+  which keeps pool allocation out of all other gauge operations.
+
+Arguments:
+
+  None
+
+Returns:
+
+  Pointer to a zeroed record, or NULL if the log is full.
+
+--*/
+{
+  EFI_TPL               OldTpl;
+  UINTN                 Index;
+  UINTN                 Chunk;
+  EFI_PERF_DATA_RECORD  *Record;
+
+  OldTpl = gBS->RaiseTPL (EFI_TPL_HIGH_LEVEL);
+  Index  = mPerfDataCount;
+  if ((Index >= EFI_PERF_DATA_MAX_COUNT) || (mPerfDataChunk[Index / EFI_PERF_DATA_CHUNK_SIZE] == NULL)) {
+    gBS->RestoreTPL (OldTpl);
+    return NULL;
+  }
+
+  mPerfDataCount++;
+  gBS->RestoreTPL (OldTpl);
+
+  Record        = PERF_DATA_RECORD (Index);
+  Record->Index = (UINT32) Index;
+
+  Chunk = Index / EFI_PERF_DATA_CHUNK_SIZE + 1;
+  if (((Index % EFI_PERF_DATA_CHUNK_SIZE) == EFI_PERF_DATA_CHUNK_SIZE - 1) &&
+      (Chunk < EFI_PERF_DATA_MAX_CHUNKS) &&
+      (mPerfDataChunk[Chunk] == NULL)) {
+    mPerfDataChunk[Chunk] = EfiLibAllocateZeroPool (EFI_PERF_DATA_CHUNK_SIZE * sizeof (EFI_PERF_DATA_RECORD));
+  }
+
+  return Record;
+}
+
+EFI_PERF_DATA_RECORD *
 CreateDataNode (
   IN EFI_HANDLE       Handle,
   IN UINT16           *Token,
@@ -281,7 +354,8 @@ CreateDataNode (
 
 Routine Description:
 
-  Create a EFI_PERF_DATA_LIST data node.
+  Reserve and initialize a gauge record. The caller publishes it by
+  setting its Signature once all other fields are filled in.
 
 Arguments:
 
@@ -295,16 +369,11 @@ Returns:
 
 --*/
 {
-  EFI_PERF_DATA_LIST  *Node;
+  EFI_PERF_DATA_RECORD  *Node;
 
-  //
-  // Al\ a new image structure
-  //
-  Node = EfiLibAllocateZeroPool (sizeof (EFI_PERF_DATA_LIST));
+  Node = ReserveDataRecord ();
   if (Node != NULL) {
 
-    Node->Signature         = EFI_PERFORMANCE_DATA_SIGNATURE;
-
     Node->GaugeData.Handle  = Handle;
 
     if (Token != NULL) {
@@ -323,8 +392,77 @@ Returns:
   return Node;
 }
 
+STATIC
+BOOLEAN
+IsMatchedDataNode (
+  IN EFI_PERF_DATA_RECORD  *Node,
+  IN EFI_HANDLE            Handle,
+  IN UINT16                *Token,
+  IN UINT16                *Host,
+  IN EFI_GUID              *GuidName
+  )
+/*++
+
+Routine Description:
+
+  Check whether a published gauge record matches handle, token, host and Guid name.
+
+Arguments:
+
+  Node      - Record to check
+  Handle    - Handle to match
+  Token     - Token to match
+  Host      - Host to match
+  GuidName  - Guid name to match
+
+Returns:
+
+  TRUE if the record matches.
+
+--*/
+{
+  EFI_GUID  NullGuid = EFI_NULL_GUID;
+
+  if (Node->Signature != EFI_PERFORMANCE_DATA_SIGNATURE) {
+    return FALSE;
+  }
+
+  if (Handle == 0 && Token == NULL && Host == NULL && GuidName == NULL) {
+    return TRUE;
+  }
+
+  if (Handle != (Node->GaugeData).Handle) {
+    return FALSE;
+  }
+
+  if (GuidName == NULL && !EfiCompareGuid (&((Node->GaugeData).GuidName), &NullGuid)) {
+    return FALSE;
+  }
+
+  if (GuidName && !EfiCompareGuid (&((Node->GaugeData).GuidName), GuidName)) {
+    return FALSE;
+  }
+
+  if (Token == NULL && EfiStrCmp (Node->GaugeData.Token, L"")) {
+    return FALSE;
+  }
+
+  if (Token && EfiStrCmp (Node->GaugeData.Token, Token)) {
+    return FALSE;
+  }
+
+  if (Host == NULL && EfiStrCmp (Node->GaugeData.Host, L"")) {
+    return FALSE;
+  }
+
+  if (Host && EfiStrCmp (Node->GaugeData.Host, Host)) {
+    return FALSE;
+  }
+
+  return TRUE;
+}
 
-EFI_PERF_DATA_LIST *
+EFI_PERF_DATA_RECORD *
 GetDataNode (
   IN EFI_HANDLE        Handle,
   IN UINT16            *Token,
@@ -336,7 +474,7 @@ GetDataNode (
 
 Routine Description:
 
-  Search gauge node list to find one node with matched handle, token, host and Guid name.
+  Search gauge records to find one with matched handle, token, host and Guid name.
 
 Arguments:
 
@@ -344,7 +482,7 @@ Arguments:
   Token     - Token to match
   Host      - Host to match
   GuidName  - Guid name to match
-  PrevGauge - Start node, start from list head if NULL
+  PrevGauge - Start node, start from the first record if NULL
 
 Returns:
 
@@ -352,70 +490,25 @@ Returns:
 
 --*/
 {
-  EFI_PERF_DATA_LIST  *Node;
-  EFI_PERF_DATA_LIST  *Temp;
-  EFI_PERF_DATA_LIST  *Temp2;
-  EFI_LIST_ENTRY      *CurrentLink;
-  EFI_GUID            NullGuid = EFI_NULL_GUID;
-
-  Node      = NULL;
-  Temp      = NULL;
-  Temp2     = NULL;
+  EFI_PERF_DATA_RECORD  *Node;
+  UINTN                 Index;
+  UINTN                 Count;
 
   if (PrevGauge == NULL) {
-    CurrentLink = mPerfDataHead.ForwardLink;
+    Index = 0;
   } else {
-    Temp2       = GAUGE_DATA_FROM_GAUGE (PrevGauge);
-    CurrentLink = (Temp2->Link).ForwardLink;
+    Index = GAUGE_DATA_FROM_GAUGE (PrevGauge)->Index + 1;
   }
 
-  while (CurrentLink && CurrentLink != &mPerfDataHead) {
-    Node = GAUGE_DATA_FROM_LINK (CurrentLink);
-
-    if (Handle == 0 && Token == NULL && Host == NULL && GuidName == NULL) {
+  Count = mPerfDataCount;
+  for (; Index < Count; Index++) {
+    Node = PERF_DATA_RECORD (Index);
+    if (IsMatchedDataNode (Node, Handle, Token, Host, GuidName)) {
       return Node;
     }
-
-    if (Handle != (Node->GaugeData).Handle) {
-      CurrentLink = CurrentLink->ForwardLink;
-      continue;
-    }
-
-    if (GuidName == NULL && !EfiCompareGuid (&((Node->GaugeData).GuidName), &NullGuid)) {
-      CurrentLink = CurrentLink->ForwardLink;
-      continue;
-    }
-
-    if (GuidName && !EfiCompareGuid (&((Node->GaugeData).GuidName), GuidName)) {
-      CurrentLink = CurrentLink->ForwardLink;
-      continue;
-    }
-
-    if (Token == NULL && EfiStrCmp (Node->GaugeData.Token, L"")) {
-      CurrentLink = CurrentLink->ForwardLink;
-      continue;
-    }
-
-    if (Token && EfiStrCmp (Node->GaugeData.Token, Token)) {
-      CurrentLink = CurrentLink->ForwardLink;
-      continue;
-    }
-
-    if (Host == NULL && EfiStrCmp (Node->GaugeData.Host, L"")) {
-      CurrentLink = CurrentLink->ForwardLink;
-      continue;
-    }
-
-    if (Host && EfiStrCmp (Node->GaugeData.Host, Host)) {
-      CurrentLink = CurrentLink->ForwardLink;
-      continue;
-    }
-
-    Temp = Node;
-    break;
   }
 
-  return Temp;
+  return NULL;
 }
 
 
@@ -450,12 +543,16 @@ Returns:
 --*/
 {
   EFI_PERFORMANCE_INSTANCE  *PerfInstance;
-  EFI_PERF_DATA_LIST        *Node;
+  EFI_PERF_DATA_RECORD      *Node;
   UINT64                    TimerValue;
 
   TimerValue    = 0;
   PerfInstance  = EFI_PERFORMANCE_FROM_THIS (This);
 
+  //
+  // Create the node, including the image name lookup, before reading the
+  // start tick so that the lookup is not part of the measured interval.
+  //
   Node          = CreateDataNode (Handle, Token, Host);
   if (!Node) {
     return EFI_OUT_OF_RESOURCES;
@@ -479,7 +576,7 @@ Returns:
 
   Node->GaugeData.Phase = PerfInstance->Phase;
 
-  InsertTailList (&mPerfDataHead, &(Node->Link));
+  Node->Signature       = EFI_PERFORMANCE_DATA_SIGNATURE;
 
   return EFI_SUCCESS;
 }
@@ -498,7 +595,9 @@ EndGauge (
 
 Routine Description:
 
-  End all unfinished gauge data node that match specified handle, token and host.
+  End the oldest unfinished gauge data node that matches specified handle,
+  token and host. The search starts at the oldest record that may still be
+  open instead of the first record.
 
 Arguments:
 
@@ -515,24 +614,12 @@ Returns:
 
 --*/
 {
-  EFI_PERFORMANCE_INSTANCE  *PerfInstance;
-  EFI_PERF_DATA_LIST        *Node;
+  EFI_PERF_DATA_RECORD      *Node;
   UINT64                    TimerValue;
+  UINTN                     Index;
+  UINTN                     Count;
 
   TimerValue    = 0;
-  PerfInstance  = EFI_PERFORMANCE_FROM_THIS (This);
-
-  Node          = GetDataNode (Handle, Token, Host, NULL, NULL);
-  if (!Node) {
-    return EFI_NOT_FOUND;
-  }
-
-  while (Node->GaugeData.EndTick != 0) {
-    Node = GetDataNode (Handle, Token, Host, NULL, &(Node->GaugeData));
-    if (!Node) {
-      return EFI_NOT_FOUND;
-    }
-  }
 
   if (Ticker != 0) {
     TimerValue = Ticker;
@@ -540,7 +627,32 @@ Returns:
     GetTimerValue (&TimerValue);
   }
 
-  Node->GaugeData.EndTick = TimerValue;
+  Count = mPerfDataCount;
+  for (Index = mPerfDataOpenIndex; Index < Count; Index++) {
+    Node = PERF_DATA_RECORD (Index);
+    if ((Node->GaugeData.EndTick == 0) && IsMatchedDataNode (Node, Handle, Token, Host, NULL)) {
+      Node->GaugeData.EndTick = TimerValue;
+      break;
+    }
+  }
+
+  if (Index == Count) {
+    return EFI_NOT_FOUND;
+  }
+  //
+  // Move the hint past the records that are now all ended. A record that is
+  // reserved but not yet published stops the scan.
+  //
+  if (Index == mPerfDataOpenIndex) {
+    while (Index < Count) {
+      Node = PERF_DATA_RECORD (Index);
+      if ((Node->Signature != EFI_PERFORMANCE_DATA_SIGNATURE) || (Node->GaugeData.EndTick == 0)) {
+        break;
+      }
+      Index++;
+    }
+    mPerfDataOpenIndex = Index;
+  }
 
   return EFI_SUCCESS;
 }
@@ -573,10 +685,7 @@ Returns:
 
 --*/
 {
-  EFI_PERFORMANCE_INSTANCE  *PerfInstance;
-  EFI_PERF_DATA_LIST        *Node;
-
-  PerfInstance  = EFI_PERFORMANCE_FROM_THIS (This);
+  EFI_PERF_DATA_RECORD      *Node;
 
   Node          = GetDataNode (Handle, Token, Host, NULL, PrevGauge);
   if (Node != NULL) {
@@ -625,6 +734,15 @@ Returns:
     return EFI_OUT_OF_RESOURCES;
   }
 
+  //
+  // Preallocate the first chunk of gauge records
+  //
+  mPerfDataChunk[0] = EfiLibAllocateZeroPool (EFI_PERF_DATA_CHUNK_SIZE * sizeof (EFI_PERF_DATA_RECORD));
+  if (mPerfDataChunk[0] == NULL) {
+    gBS->FreePool (PerfInstance);
+    return EFI_OUT_OF_RESOURCES;
+  }
+
   PerfInstance->Signature       = EFI_PERFORMANCE_SIGNATURE;
   PerfInstance->Perf.StartGauge = StartGauge;
   PerfInstance->Perf.EndGauge   = EndGauge;
@@ -647,6 +765,41 @@ Returns:
   return EFI_SUCCESS;
 }
 
+STATIC
+EFI_STATUS
+LocatePerformanceProtocol (
+  OUT EFI_PERFORMANCE_PROTOCOL  **Perf
+  )
+/*++
+
+Routine Description:
+
+  Locate the performance protocol once and cache it for later measurements.
+
+Arguments:
+
+  Perf  - The performance protocol
+
+Returns:
+
+  Status code.
+
+--*/
+{
+  EFI_STATUS  Status;
+
+  if (mPerformance == NULL) {
+    Status = gBS->LocateProtocol (&gEfiPerformanceProtocolGuid, NULL, (VOID **) &mPerformance);
+    if (EFI_ERROR (Status)) {
+      mPerformance = NULL;
+      return Status;
+    }
+  }
+
+  *Perf = mPerformance;
+  return EFI_SUCCESS;
+}
+
 
 EFI_STATUS
 StartMeasure (
@@ -677,7 +830,7 @@ Returns:
   EFI_STATUS                Status;
   EFI_PERFORMANCE_PROTOCOL  *Perf;
 
-  Status = gBS->LocateProtocol (&gEfiPerformanceProtocolGuid, NULL, (VOID **) &Perf);
+  Status = LocatePerformanceProtocol (&Perf);
   if (EFI_ERROR (Status)) {
     return Status;
   }
@@ -716,7 +869,7 @@ Returns:
   EFI_STATUS                Status;
   EFI_PERFORMANCE_PROTOCOL  *Perf;
 
-  Status = gBS->LocateProtocol (&gEfiPerformanceProtocolGuid, NULL, (VOID **) &Perf);
+  Status = LocatePerformanceProtocol (&Perf);
   if (Status != EFI_SUCCESS) {
     return Status;
   }
@@ -760,7 +913,7 @@ Returns:
   EFI_GAUGE_DATA            *GaugeData;
   EFI_PERFORMANCE_PROTOCOL  *Perf;
 
-  Status = gBS->LocateProtocol (&gEfiPerformanceProtocolGuid, NULL, (VOID **) &Perf);
+  Status = LocatePerformanceProtocol (&Perf);
   if (EFI_ERROR (Status)) {
     return Status;
   }
@@ -817,7 +970,7 @@ Returns:
   EFI_HOB_GUID_DATA_PERFORMANCE_LOG *LogHob;
   PEI_PERFORMANCE_MEASURE_LOG_ENTRY *LogEntry;
   UINT32                            Index;
-  EFI_PERF_DATA_LIST                *Node;
+  EFI_PERF_DATA_RECORD              *Node;
   UINT64                            TimerValue;
 
   Node = CreateDataNode (0, PEI_TOK, NULL);
@@ -832,7 +985,7 @@ Returns:
   }
   (Node->GaugeData).EndTick = TimerValue;
 
-  InsertTailList (&mPerfDataHead, &(Node->Link));
+  Node->Signature           = EFI_PERFORMANCE_DATA_SIGNATURE;
 
   EfiLibGetSystemConfigurationTable (&gEfiHobListGuid, &HobList);
   do {
@@ -851,9 +1004,9 @@ Returns:
 
       EfiCopyMem (&(Node->GaugeData.GuidName), &LogEntry->Name, sizeof (EFI_GUID));
 
-      InsertTailList (&mPerfDataHead, &(Node->Link));
-
       (Node->GaugeData).EndTick = LogEntry->StopTimeCount;
+
+      Node->Signature           = EFI_PERFORMANCE_DATA_SIGNATURE;
     }
   } while (!EFI_ERROR (Status));
 
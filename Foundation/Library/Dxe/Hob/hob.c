@@ -24,6 +24,25 @@ Abstract:
 #include "PeiHob.h"
 #include EFI_GUID_DEFINITION (IoBaseHob)
 #include EFI_GUID_DEFINITION (MemoryAllocationHob)
+#include EFI_GUID_DEFINITION (Hob)
+
+//
+// GUID HOB index. The HOB list does not change once DXE has started, so the
+// first GetNextGuidHob() call made with boot services available walks the
+// list once and records every GUID extension HOB sorted by (GUID, address).
+// Later lookups are a binary search instead of a walk of the whole list.
+// The HOB list format itself is left untouched.
+//
+typedef struct {
+  UINT32  *Name;
+  UINT8   *Hob;
+} HOB_GUID_INDEX_ENTRY;
+
+STATIC BOOLEAN               mHobGuidIndexBuilt  = FALSE;
+STATIC UINT8                 *mHobListStart      = NULL;
+STATIC UINT8                 *mHobListEnd        = NULL;
+STATIC HOB_GUID_INDEX_ENTRY  *mHobGuidIndex      = NULL;
+STATIC UINTN                 mHobGuidIndexCount  = 0;
 
 VOID *
 GetHob (
@@ -374,6 +393,209 @@ Returns:
 }
 #endif
 
+STATIC
+INTN
+CompareHobGuidIndexKey (
+  IN UINT32  *Name,
+  IN UINT8   *Hob,
+  IN HOB_GUID_INDEX_ENTRY  *Entry
+  )
+/*++
+
+Routine Description:
+
+  Compare a (GUID, HOB address) key against an index entry.
+
+Arguments:
+
+  Name    - GUID of the key, viewed as four UINT32 words
+  Hob     - HOB address of the key
+  Entry   - Index entry to compare with
+
+Returns:
+
+  < 0 if the key sorts before the entry, 0 if equal, > 0 if after.
+
+--*/
+{
+  UINTN  Index;
+
+  for (Index = 0; Index < sizeof (EFI_GUID) / sizeof (UINT32); Index++) {
+    if (Name[Index] != Entry->Name[Index]) {
+      return (Name[Index] < Entry->Name[Index]) ? -1 : 1;
+    }
+  }
+
+  if (Hob == Entry->Hob) {
+    return 0;
+  }
+  return ((UINTN) Hob < (UINTN) Entry->Hob) ? -1 : 1;
+}
+
+STATIC
+VOID
+BuildHobGuidIndex (
+  VOID
+  )
+/*++
+
+Routine Description:
+
+  Build the GUID HOB index for the HOB list published in the system table.
+  The index is only attempted once; if boot services or the HOB list are not
+  available yet, or the allocation fails, lookups keep using the linear walk.
+
+Arguments:
+
+  None
+
+Returns:
+
+  None
+
+--*/
+{
+  EFI_STATUS            Status;
+  EFI_PEI_HOB_POINTERS  Hob;
+  VOID                  *HobList;
+  UINTN                 Count;
+  UINTN                 Gap;
+  UINTN                 Index;
+  UINTN                 Walk;
+  HOB_GUID_INDEX_ENTRY  Temp;
+
+  if ((gST == NULL) || (gBS == NULL)) {
+    return;
+  }
+
+  Status = EfiLibGetSystemConfigurationTable (&gEfiHobListGuid, &HobList);
+  if (EFI_ERROR (Status) || (HobList == NULL)) {
+    return;
+  }
+  mHobGuidIndexBuilt = TRUE;
+
+  Count   = 0;
+  Hob.Raw = HobList;
+  while (!END_OF_HOB_LIST (Hob)) {
+    if (Hob.Header->HobType == EFI_HOB_TYPE_GUID_EXTENSION) {
+      Count++;
+    }
+    Hob.Raw = GET_NEXT_HOB (Hob);
+  }
+
+  if (Count != 0) {
+    Status = gBS->AllocatePool (
+                    EfiBootServicesData,
+                    Count * sizeof (HOB_GUID_INDEX_ENTRY),
+                    (VOID **) &mHobGuidIndex
+                    );
+    if (EFI_ERROR (Status)) {
+      mHobGuidIndex = NULL;
+      return;
+    }
+  }
+
+  Count   = 0;
+  Hob.Raw = HobList;
+  while (!END_OF_HOB_LIST (Hob)) {
+    if (Hob.Header->HobType == EFI_HOB_TYPE_GUID_EXTENSION) {
+      mHobGuidIndex[Count].Name = (UINT32 *) &Hob.Guid->Name;
+      mHobGuidIndex[Count].Hob  = Hob.Raw;
+      Count++;
+    }
+    Hob.Raw = GET_NEXT_HOB (Hob);
+  }
+
+  //
+  // Shell sort by (GUID, address). Entries were collected in address order,
+  // so HOBs sharing a GUID stay in list order.
+  //
+  for (Gap = Count / 2; Gap > 0; Gap /= 2) {
+    for (Index = Gap; Index < Count; Index++) {
+      Temp = mHobGuidIndex[Index];
+      for (Walk = Index;
+           (Walk >= Gap) && (CompareHobGuidIndexKey (Temp.Name, Temp.Hob, &mHobGuidIndex[Walk - Gap]) < 0);
+           Walk -= Gap) {
+        mHobGuidIndex[Walk] = mHobGuidIndex[Walk - Gap];
+      }
+      mHobGuidIndex[Walk] = Temp;
+    }
+  }
+
+  mHobGuidIndexCount = Count;
+  mHobListStart      = (UINT8 *) HobList;
+  mHobListEnd        = Hob.Raw;
+}
+
+STATIC
+EFI_STATUS
+LookupHobGuidIndex (
+  IN     VOID      *HobStart,
+  IN     EFI_GUID  *Guid,
+  OUT    UINT8     **GuidHob
+  )
+/*++
+
+Routine Description:
+
+  Find the first GUID extension HOB named Guid at or after HobStart
+  using the GUID HOB index.
+
+Arguments:
+
+  HobStart  - Position in the HOB list to search from
+  Guid      - GUID to search for
+  GuidHob   - The matching HOB, or the end of HOB list HOB if none
+
+Returns:
+
+  EFI_SUCCESS       - A matching HOB was found
+  EFI_NOT_FOUND     - No matching HOB follows HobStart
+  EFI_UNSUPPORTED   - HobStart is not covered by the index
+
+--*/
+{
+  UINTN                 Low;
+  UINTN                 High;
+  UINTN                 Middle;
+  HOB_GUID_INDEX_ENTRY  *Entry;
+
+  if (!mHobGuidIndexBuilt) {
+    BuildHobGuidIndex ();
+  }
+
+  if ((mHobListStart == NULL) ||
+      ((UINT8 *) HobStart < mHobListStart) ||
+      ((UINT8 *) HobStart > mHobListEnd)) {
+    return EFI_UNSUPPORTED;
+  }
+
+  //
+  // Lower bound of (Guid, HobStart)
+  //
+  Low  = 0;
+  High = mHobGuidIndexCount;
+  while (Low < High) {
+    Middle = (Low + High) / 2;
+    if (CompareHobGuidIndexKey ((UINT32 *) Guid, (UINT8 *) HobStart, &mHobGuidIndex[Middle]) > 0) {
+      Low = Middle + 1;
+    } else {
+      High = Middle;
+    }
+  }
+
+  if (Low < mHobGuidIndexCount) {
+    Entry = &mHobGuidIndex[Low];
+    if (EfiCompareGuid (Guid, (EFI_GUID *) Entry->Name)) {
+      *GuidHob = Entry->Hob;
+      return EFI_SUCCESS;
+    }
+  }
+
+  *GuidHob = mHobListEnd;
+  return EFI_NOT_FOUND;
+}
+
 EFI_STATUS
 GetNextGuidHob (
   IN OUT VOID      **HobStart,
@@ -410,6 +632,20 @@ Returns:
     return EFI_INVALID_PARAMETER;
   }
 
+  Status = LookupHobGuidIndex (*HobStart, Guid, &GuidHob.Raw);
+  if (Status == EFI_SUCCESS) {
+    *Buffer = (VOID *) ((UINT8 *) (&GuidHob.Guid->Name) + sizeof (EFI_GUID));
+    if (BufferSize != NULL) {
+      *BufferSize = GuidHob.Header->HobLength - sizeof (EFI_HOB_GUID_TYPE);
+    }
+    *HobStart = GET_NEXT_HOB (GuidHob);
+    return EFI_SUCCESS;
+  }
+  if (Status == EFI_NOT_FOUND) {
+    *HobStart = GuidHob.Raw;
+    return EFI_NOT_FOUND;
+  }
+
   for (Status = EFI_NOT_FOUND; EFI_ERROR (Status);) {
 
     GuidHob.Raw = *HobStart;
@@ -51,11 +51,20 @@ Returns:
 {
   INTN ReturnValue;
 
-  if (!(EFI_UINTN_ALIGNED (MemOne) || EFI_UINTN_ALIGNED (MemTwo) || EFI_UINTN_ALIGNED (Length))) {
+  if (EFI_UINTN_ALIGNED (MemOne) == EFI_UINTN_ALIGNED (MemTwo)) {
     //
-    // If Destination/Source/Length are aligned do UINTN conpare
+    // If Destination/Source are equally aligned, byte compare up to the
+    // first UINTN boundary and then do UINTN compare. Length need not be
+    // aligned; the tail is left to the byte compare below.
     //
-    for (; Length > 0; Length -= sizeof (INTN), MemOne = (VOID *)((UINTN)MemOne + sizeof (INTN)), MemTwo = (VOID *)((UINTN)MemTwo + sizeof (INTN))) {
+    for (; (Length > 0) && (EFI_UINTN_ALIGNED (MemOne) != 0); Length--, MemOne = (VOID *)((UINTN)MemOne + 1), MemTwo = (VOID *)((UINTN)MemTwo + 1)) {
+      ReturnValue = (INTN)(*(INT8 *)MemOne - *(INT8 *)MemTwo);
+      if (ReturnValue != 0) {
+        return ReturnValue;
+      }
+    }
+
+    for (; Length >= sizeof (INTN); Length -= sizeof (INTN), MemOne = (VOID *)((UINTN)MemOne + sizeof (INTN)), MemTwo = (VOID *)((UINTN)MemTwo + sizeof (INTN))) {
       if (*(INTN *)MemOne != *(INTN *)MemTwo) {
         break;
       }
@@ -63,7 +72,7 @@ Returns:
   }
 
   //
-  // If Destination/Source/Length not aligned do byte compare
+  // Byte compare the remainder, including the first UINTN that differed
   //
   for (; Length > 0; Length--, MemOne = (VOID *)((UINTN)MemOne + 1), MemTwo = (VOID *)((UINTN)MemTwo + 1)) {
     ReturnValue = (INTN)(*(INT8 *)MemOne - *(INT8 *)MemTwo);
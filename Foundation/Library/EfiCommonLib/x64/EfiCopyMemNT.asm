@@ -0,0 +1,95 @@
+;------------------------------------------------------------------------------
+;
+; Copyright (c) 2007, Intel Corporation
+; All rights reserved. This program and the accompanying materials
+; are licensed and made available under the terms and conditions of the BSD License
+; which accompanies this distribution.  The full text of the license may be found at
+; http://opensource.org/licenses/bsd-license.php
+;
+; THE PROGRAM IS DISTRIBUTED UNDER THE BSD LICENSE ON AN "AS IS" BASIS,
+; WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
+;
+; Module Name:
+;
+;   EfiCopyMemNT.asm
+;
+; Abstract:
+;
+;   CopyMem function
+;
+; Notes:
+;
+;   Copies are done with rep movsq. Forward copies of at least
+;   NT_COPY_THRESHOLD bytes are streamed with non-temporal SSE2 stores
+;   instead, so that a large copy does not evict the whole cache.
+;
+;------------------------------------------------------------------------------
+
+NT_COPY_THRESHOLD   EQU     100000h
+
+    .code
+
+;------------------------------------------------------------------------------
+; VOID
+; EfiCommonLibCopyMem (
+;   OUT     VOID                      *Destination,
+;   IN      VOID                      *Source,
+;   IN      UINTN                     Count
+;   );
+;------------------------------------------------------------------------------
+EfiCommonLibCopyMem  PROC    USES    rsi rdi
+    cmp     rdx, rcx                    ; if Source == Destination, do nothing
+    je      @CopyMemDone
+    cmp     r8, 0                       ; if Count == 0, do nothing
+    je      @CopyMemDone
+    mov     rsi, rdx                    ; rsi <- Source
+    mov     rdi, rcx                    ; rdi <- Destination
+    lea     r9, [rsi + r8 - 1]          ; r9 <- End of Source
+    cmp     rsi, rdi
+    jae     @F
+    cmp     r9, rdi
+    jae     @CopyBackward               ; Copy backward if overlapped
+@@:
+    cmp     r8, NT_COPY_THRESHOLD
+    jb      @CopyQwords
+    xor     rcx, rcx
+    sub     rcx, rdi                    ; rcx <- -rdi
+    and     rcx, 15                     ; rcx + rdi should be 16 bytes aligned
+    sub     r8, rcx
+    rep     movsb
+    mov     rcx, r8
+    and     r8, 63
+    shr     rcx, 6                      ; rcx <- # of 64-byte lines to copy
+@@:
+    movdqu  xmm0, [rsi]                 ; rsi may not be 16-byte aligned
+    movdqu  xmm1, [rsi + 16]
+    movdqu  xmm2, [rsi + 32]
+    movdqu  xmm3, [rsi + 48]
+    movntdq [rdi], xmm0                 ; rdi should be 16-byte aligned
+    movntdq [rdi + 16], xmm1
+    movntdq [rdi + 32], xmm2
+    movntdq [rdi + 48], xmm3
+    add     rsi, 64
+    add     rdi, 64
+    dec     rcx
+    jnz     @B
+    sfence                              ; order the streaming stores
+@CopyQwords:
+    mov     rcx, r8
+    and     r8, 7
+    shr     rcx, 3
+    rep     movsq                       ; Copy as many Qwords as possible
+    jmp     @CopyBytes
+@CopyBackward:
+    mov     rsi, r9                     ; rsi <- End of Source
+    lea     rdi, [rdi + r8 - 1]         ; rdi <- End of Destination
+    std                                 ; set direction flag
+@CopyBytes:
+    mov     rcx, r8
+    rep     movsb                       ; Copy bytes backward
+    cld
+@CopyMemDone:
+    ret
+EfiCommonLibCopyMem  ENDP
+
+    END
@@ -0,0 +1,72 @@
+;------------------------------------------------------------------------------
+;
+; Copyright (c) 2007, Intel Corporation
+; All rights reserved. This program and the accompanying materials
+; are licensed and made available under the terms and conditions of the BSD License
+; which accompanies this distribution.  The full text of the license may be found at
+; http://opensource.org/licenses/bsd-license.php
+;
+; THE PROGRAM IS DISTRIBUTED UNDER THE BSD LICENSE ON AN "AS IS" BASIS,
+; WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
+;
+; Module Name:
+;
+;   EfiZeroMemNT.asm
+;
+; Abstract:
+;
+;   ZeroMem function
+;
+; Notes:
+;
+;   Buffers are cleared with rep stosq. Buffers of at least
+;   NT_ZERO_THRESHOLD bytes are cleared with non-temporal SSE2 stores
+;   instead, so that a large clear does not evict the whole cache.
+;
+;------------------------------------------------------------------------------
+
+NT_ZERO_THRESHOLD   EQU     100000h
+
+    .code
+
+;------------------------------------------------------------------------------
+;  VOID
+;  EfiCommonLibZeroMem (
+;    IN VOID   *Buffer,
+;    IN UINTN  Size
+;    );
+;------------------------------------------------------------------------------
+EfiCommonLibZeroMem  PROC    USES    rdi
+    xor     rax, rax
+    mov     rdi, rcx
+    cmp     rdx, NT_ZERO_THRESHOLD
+    jb      @ZeroQwords
+    xor     rcx, rcx
+    sub     rcx, rdi
+    and     rcx, 15                     ; rcx + rdi should be 16 bytes aligned
+    sub     rdx, rcx
+    rep     stosb
+    mov     rcx, rdx
+    and     rdx, 63
+    shr     rcx, 6                      ; rcx <- # of 64-byte lines to clear
+    pxor    xmm0, xmm0
+@@:
+    movntdq [rdi], xmm0                 ; rdi should be 16-byte aligned
+    movntdq [rdi + 16], xmm0
+    movntdq [rdi + 32], xmm0
+    movntdq [rdi + 48], xmm0
+    add     rdi, 64
+    dec     rcx
+    jnz     @B
+    sfence                              ; order the streaming stores
+@ZeroQwords:
+    mov     rcx, rdx
+    shr     rcx, 3
+    and     rdx, 7
+    rep     stosq
+    mov     rcx, rdx
+    rep     stosb
+    ret
+EfiCommonLibZeroMem  ENDP
+
+    END
@@ -0,0 +1,94 @@
+/*++
+
+Copyright (c) 2004, Intel Corporation                                                         
+All rights reserved. This program and the accompanying materials                          
+are licensed and made available under the terms and conditions of the BSD License         
+which accompanies this distribution.  The full text of the license may be found at        
+http://opensource.org/licenses/bsd-license.php                                            
+                                                                                          
+THE PROGRAM IS DISTRIBUTED UNDER THE BSD LICENSE ON AN "AS IS" BASIS,                     
+WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.             
+
+Module Name:
+
+  FaultTolerantWriteLiteBatch.h
+
+Abstract:
+
+  Batched write extension of the fault tolerant write lite driver. It is
+  installed next to the FaultTolerantWriteLite protocol by drivers that
+  support it, so consumers of the original protocol are not affected.
+
+--*/
+
+#ifndef _FW_FAULT_TOLERANT_WRITE_LITE_BATCH_PROTOCOL_H_
+#define _FW_FAULT_TOLERANT_WRITE_LITE_BATCH_PROTOCOL_H_
+
+#define EFI_FTW_LITE_BATCH_PROTOCOL_GUID \
+{ 0x81343fdb, 0x8ac8, 0x4ca2, 0xbf, 0x9e, 0xbc, 0xb6, 0x10, 0xd7, 0x19, 0xea }
+
+//
+// Forward reference for pure ANSI compatability
+//
+EFI_FORWARD_DECLARATION (EFI_FTW_LITE_BATCH_PROTOCOL);
+
+//
+// One entry of a WriteBatch () request list
+//
+typedef struct {
+  EFI_HANDLE                       FvbHandle;
+  EFI_LBA                          Lba;
+  UINTN                            Offset;
+  UINTN                            NumBytes;
+  VOID                             *Buffer;
+} EFI_FTW_LITE_WRITE_REQUEST;
+
+//
+// Protocol API definitions
+//
+
+typedef
+EFI_STATUS
+(EFIAPI * EFI_FTW_LITE_WRITE_BATCH) (
+  IN EFI_FTW_LITE_BATCH_PROTOCOL       *This,
+  IN UINTN                             RequestCount,
+  IN EFI_FTW_LITE_WRITE_REQUEST        *Requests
+  );
+/*++
+
+Routine Description:
+
+  Performs a list of target block updates in order. Consecutive requests 
+  on the same FVB that fall within one spare area sized window share one 
+  fault tolerant record and one spare block cycle, so updating several 
+  nearby ranges costs a single erase of the spare block instead of one 
+  per range. Each window is updated atomically; the batch as a whole is not.
+
+Arguments:
+
+  This             - Calling context
+  RequestCount     - The number of entries in Requests.
+  Requests         - The writes to perform.
+
+Returns:
+
+  EFI_SUCCESS          - The function completed successfully
+  EFI_ABORTED          - The function could not complete successfully.
+  EFI_BAD_BUFFER_SIZE  - A write would span a block boundary, 
+                         which is not a valid action.
+  EFI_ACCESS_DENIED    - No writes have been allocated.
+  EFI_NOT_READY        - The last write has not been completed.  
+                         Restart () must be called to complete it.
+
+--*/
+
+//
+// Protocol declaration
+//
+typedef struct _EFI_FTW_LITE_BATCH_PROTOCOL {
+  EFI_FTW_LITE_WRITE_BATCH         WriteBatch;
+} EFI_FTW_LITE_BATCH_PROTOCOL;
+
+extern EFI_GUID gEfiFaultTolerantWriteLiteBatchProtocolGuid;
+
+#endif
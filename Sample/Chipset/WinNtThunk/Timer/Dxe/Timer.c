@@ -62,9 +62,12 @@ UINT64                  mTimerPeriod;
 HANDLE                  mNtMainThreadHandle;
 
 //
-// The timer value from the last timer interrupt
+// The performance counter value from the last timer interrupt, and the
+// performance counter frequency in counts per second. The performance
+// counter is monotonic and much finer grained than GetTickCount ().
 //
-UINT32                  mNtLastTick;
+UINT64                  mNtLastCount;
+UINT64                  mNtCounterFrequency;
 
 //
 // Critical section used to update varibles shared between the main thread and
@@ -107,8 +110,8 @@ Returns:
 --*/
 {
   EFI_TPL           OriginalTPL;
-  UINT32            CurrentTick;
-  UINT32            Delta;
+  UINT64            CurrentCount;
+  UINT64            Delta;
   EFI_TIMER_NOTIFY  CallbackFunction;
   BOOLEAN           InterruptState;
 
@@ -161,23 +164,22 @@ Returns:
     }
 
     //
-    //  Get the current system tick
+    //  Get the current performance counter
     //
-    CurrentTick = gWinNt->GetTickCount ();
-    Delta       = CurrentTick - mNtLastTick;
-    mNtLastTick = CurrentTick;
+    gWinNt->QueryPerformanceCounter ((LARGE_INTEGER *) &CurrentCount);
+    Delta         = CurrentCount - mNtLastCount;
+    mNtLastCount  = CurrentCount;
 
     //
     //  If delay was more then 1 second, ignore it (probably debugging case)
     //
-    if (Delta < 1000) {
+    if (Delta < mNtCounterFrequency) {
 
       OriginalTPL = gBS->RaiseTPL (EFI_TPL_HIGH_LEVEL);
 
       //
       //  Inform the firmware of an "timer interrupt".  The time
-      //  expired since the last call is 10,000 times the number
-      //  of ms.  (or 100ns units)
+      //  expired since the last call is passed in 100ns units.
       //
       CallbackFunction = mTimerNotifyFunction;
 
@@ -186,7 +188,7 @@ Returns:
       // registered. Assume all other handlers are legal.
       //
       if (CallbackFunction != NULL) {
-        CallbackFunction ((UINT64) (Delta * 10000));
+        CallbackFunction (DivU64x32 (MultU64x32 (Delta, 10000000), (UINTN) mNtCounterFrequency, NULL));
       }
 
       gBS->RestoreTPL (OriginalTPL);
@@ -417,7 +419,7 @@ Returns:
     //
     //  Get the starting tick location if we are just starting the timer thread
     //
-    mNtLastTick = gWinNt->GetTickCount ();
+    gWinNt->QueryPerformanceCounter ((LARGE_INTEGER *) &mNtLastCount);
 
     if (mMMTimerThreadID) {
       gWinNt->timeKillEvent (mMMTimerThreadID);
@@ -576,6 +578,8 @@ Returns:
   //
   gWinNt->InitializeCriticalSection (&mNtCriticalSection);
 
+  gWinNt->QueryPerformanceFrequency ((LARGE_INTEGER *) &mNtCounterFrequency);
+
   //
   // Start the timer thread at the default timer period
   //
@@ -47,6 +47,16 @@ Abstract:
 
 #define EFI_CPU_DATA_MAXIMUM_LENGTH 0x100
 
+//
+// Host performance counter interval the TSC is calibrated over, 1/100 s
+//
+#define TSC_CALIBRATION_DIVISOR     100
+
+//
+// Period of CPU timer 0 in femtoseconds, 0 until it has been calibrated
+//
+STATIC UINT64 mTimerPeriod = 0;
+
 EFI_STATUS
 EFIAPI
 InitializeCpu (
@@ -326,8 +336,10 @@ WinNtGetTimerValue (
 
 Routine Description:
 
-  This routine would support querying of an on-CPU timer.  At present, 
-  this code does not provide timer emulation.  
+  Return the time stamp counter as CPU timer 0, like a real IA32 CPU
+  driver does, so that it is the same clock that Perf, the PEI performance
+  log and the DXE core profile read. The period is calibrated once against
+  the host's performance counter the first time it is asked for.
 
 Arguments:
 
@@ -338,19 +350,47 @@ Arguments:
 
 Returns:
 
-  EFI_UNSUPPORTED       - not yet implemented
-  EFI_INVALID_PARAMETER - TimeValue is NULL
+  EFI_SUCCESS           - TimerValue, and TimerPeriod, returned
+  EFI_INVALID_PARAMETER - TimeValue is NULL or TimerIndex is not 0
 
 --*/
 {
-  if (TimerValue == NULL) {
+  UINT64  Frequency;
+  UINT64  StartCount;
+  UINT64  EndCount;
+  UINT64  StartTsc;
+  UINT64  EndTsc;
+  UINT64  ElapsedNs;
+
+  if (TimerValue == NULL || TimerIndex != 0) {
     return EFI_INVALID_PARAMETER;
   }
-  
-  //
-  // No timer supported
-  //
-  return EFI_UNSUPPORTED;
+
+  if ((TimerPeriod != NULL) && (mTimerPeriod == 0)) {
+    gWinNt->QueryPerformanceFrequency ((LARGE_INTEGER *) &Frequency);
+    gWinNt->QueryPerformanceCounter ((LARGE_INTEGER *) &StartCount);
+    StartTsc = EfiReadTsc ();
+    do {
+      gWinNt->QueryPerformanceCounter ((LARGE_INTEGER *) &EndCount);
+    } while (EndCount - StartCount < DivU64x32 (Frequency, TSC_CALIBRATION_DIVISOR, NULL));
+    EndTsc = EfiReadTsc ();
+
+    ElapsedNs = DivU64x32 (MultU64x32 (EndCount - StartCount, 1000000000), (UINTN) Frequency, NULL);
+    if (EndTsc > StartTsc) {
+      //
+      // The period is in femtoseconds.
+      //
+      mTimerPeriod = DivU64x32 (MultU64x32 (ElapsedNs, 1000000), (UINTN) (EndTsc - StartTsc), NULL);
+    }
+  }
+
+  *TimerValue = EfiReadTsc ();
+
+  if (TimerPeriod != NULL) {
+    *TimerPeriod = mTimerPeriod;
+  }
+
+  return EFI_SUCCESS;
 }
 
 STATIC
@@ -463,7 +503,7 @@ Returns:
   Private->Cpu.GetTimerValue            = WinNtGetTimerValue;
   Private->Cpu.SetMemoryAttributes      = WinNtSetMemoryAttributes;
 
-  Private->Cpu.NumberOfTimers           = 0;
+  Private->Cpu.NumberOfTimers           = 1;
   Private->Cpu.DmaBufferAlignment       = 4;
 
   Private->InterruptState               = TRUE;
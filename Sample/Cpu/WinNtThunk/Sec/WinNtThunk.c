@@ -196,7 +196,9 @@ EFI_WIN_NT_THUNK_PROTOCOL mWinNtThunkTable = {
   DispatchMessage,
   GetProcessHeap,
   HeapAlloc,
-  HeapFree
+  HeapFree,
+  QueryPerformanceCounter,
+  QueryPerformanceFrequency
 };
 
 #pragma warning(default : 4232)
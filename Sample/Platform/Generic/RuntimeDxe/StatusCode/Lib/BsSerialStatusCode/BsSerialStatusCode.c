@@ -2094,6 +2094,187 @@ Returns:
 }
 #endif
 
+//
+// Output is queued in a ring and drained to the UART from a periodic timer
+// event at EFI_TPL_CALLBACK. Each tick loads the transmit FIFO once if it
+// is empty and never waits for the UART, so a port that stops draining
+// can't hold up other callbacks. The reporter only blocks on the UART when
+// the ring is full, when an error is reported, and once boot services are
+// gone.
+//
+#define SERIAL_RING_SIZE          0x4000
+#define SERIAL_FIFO_SIZE          16
+#define SERIAL_DRAIN_PERIOD       10000
+
+STATIC UINT8      mSerialRing[SERIAL_RING_SIZE];
+STATIC UINTN      mSerialRingHead   = 0;
+STATIC UINTN      mSerialRingTail   = 0;
+STATIC UINTN      mSerialFifoSize   = 1;
+STATIC BOOLEAN    mSerialDeferred   = FALSE;
+STATIC EFI_EVENT  mSerialDrainEvent = NULL;
+STATIC EFI_EVENT  mSerialExitBootServicesEvent = NULL;
+
+STATIC
+VOID
+SerialRingFlush (
+  VOID
+  )
+/*++
+
+Routine Description:
+
+  Write every queued byte to the UART, waiting for it as needed.
+  Caller must be at EFI_TPL_HIGH_LEVEL or have deferred output disabled.
+
+Arguments:
+
+  None
+
+Returns:
+
+  None
+
+--*/
+{
+  while (mSerialRingHead != mSerialRingTail) {
+    DebugSerialWrite (mSerialRing[mSerialRingHead]);
+    mSerialRingHead = (mSerialRingHead + 1) % SERIAL_RING_SIZE;
+  }
+}
+
+STATIC
+VOID
+EFIAPI
+SerialRingDrain (
+  IN EFI_EVENT  Event,
+  IN VOID       *Context
+  )
+/*++
+
+Routine Description:
+
+  Timer notification. If the transmitter is empty, write up to
+  mSerialFifoSize queued bytes to it, otherwise leave the ring for the
+  next tick.
+
+Arguments:
+
+  Event   - The drain timer event
+  Context - Unused
+
+Returns:
+
+  None
+
+--*/
+{
+  EFI_TPL OldTpl;
+  UINTN   Count;
+
+  //
+  // Lock the ring first, the reporter may write it out directly.
+  //
+  OldTpl = gBS->RaiseTPL (EFI_TPL_HIGH_LEVEL);
+
+  if ((mSerialRingHead != mSerialRingTail) &&
+      ((IoRead8 (gComBase + LSR_OFFSET) & LSR_TXRDY) != 0)) {
+    for (Count = 0;
+         (Count < mSerialFifoSize) && (mSerialRingHead != mSerialRingTail);
+         Count++) {
+      IoWrite8 (gComBase, mSerialRing[mSerialRingHead]);
+      mSerialRingHead = (mSerialRingHead + 1) % SERIAL_RING_SIZE;
+    }
+  }
+
+  gBS->RestoreTPL (OldTpl);
+}
+
+STATIC
+VOID
+EFIAPI
+SerialExitBootServices (
+  IN EFI_EVENT  Event,
+  IN VOID       *Context
+  )
+/*++
+
+Routine Description:
+
+  Flush the ring and fall back to synchronous output, since there is no
+  timer to drain it after ExitBootServices ().
+
+Arguments:
+
+  Event   - The exit boot services event
+  Context - Unused
+
+Returns:
+
+  None
+
+--*/
+{
+  EFI_TPL OldTpl;
+
+  OldTpl = gBS->RaiseTPL (EFI_TPL_HIGH_LEVEL);
+  SerialRingFlush ();
+  mSerialDeferred = FALSE;
+  gBS->RestoreTPL (OldTpl);
+}
+
+STATIC
+VOID
+SerialOutput (
+  IN UINT8    *OutputString,
+  IN BOOLEAN  Flush
+  )
+/*++
+
+Routine Description:
+
+  Queue a string for the UART, or print it directly if output is not
+  deferred.
+
+Arguments:
+
+  OutputString - Ascii string to print to serial port.
+  Flush        - TRUE to write everything queued before returning.
+
+Returns:
+
+  None
+
+--*/
+{
+  EFI_TPL OldTpl;
+  UINTN   Next;
+
+  if (!mSerialDeferred) {
+    DebugSerialPrint (OutputString);
+    return ;
+  }
+
+  OldTpl = gBS->RaiseTPL (EFI_TPL_HIGH_LEVEL);
+  for (; *OutputString != 0; OutputString++) {
+    Next = (mSerialRingTail + 1) % SERIAL_RING_SIZE;
+    if (Next == mSerialRingHead) {
+      //
+      // Ring is full, make room by writing the oldest byte.
+      //
+      DebugSerialWrite (mSerialRing[mSerialRingHead]);
+      mSerialRingHead = (mSerialRingHead + 1) % SERIAL_RING_SIZE;
+    }
+
+    mSerialRing[mSerialRingTail] = *OutputString;
+    mSerialRingTail              = Next;
+  }
+
+  if (Flush) {
+    SerialRingFlush ();
+  }
+  gBS->RestoreTPL (OldTpl);
+}
+
 VOID
 EFIAPI
 BsSerialInitializeStatusCode (
@@ -2120,9 +2301,10 @@ Returns:
 
 --*/
 {
-  UINTN Divisor;
-  UINT8 OutputData;
-  UINT8 Data;
+  EFI_STATUS  Status;
+  UINTN       Divisor;
+  UINT8       OutputData;
+  UINT8       Data;
 
   //
   // Some init is done by the platform status code initialization.
@@ -2154,6 +2336,53 @@ Returns:
   //
   OutputData = (UINT8) ((~DLAB << 7) | ((gBreakSet << 6) | ((gParity << 3) | ((gStop << 2) | Data))));
   IoWrite8 (gComBase + LCR_OFFSET, OutputData);
+
+  //
+  // Enable and reset the FIFOs so the drain timer can load a full FIFO
+  // each time the transmitter is empty. An 8250/16450 has no FIFO and reads
+  // the enable bits of EIR back as zero, so it gets one byte per THRE.
+  //
+  IoWrite8 (gComBase + FCR_OFFSET, FCR_FIFO_ENABLE | FCR_RX_RESET | FCR_TX_RESET);
+  if ((IoRead8 (gComBase + EIR_OFFSET) & EIR_FIFO_MASK) == EIR_FIFO_MASK) {
+    mSerialFifoSize = SERIAL_FIFO_SIZE;
+  } else {
+    mSerialFifoSize = 1;
+  }
+
+  //
+  // Defer output to a timer event for as long as boot services are available.
+  //
+  Status = gBS->CreateEvent (
+                  EFI_EVENT_TIMER | EFI_EVENT_NOTIFY_SIGNAL,
+                  EFI_TPL_CALLBACK,
+                  SerialRingDrain,
+                  NULL,
+                  &mSerialDrainEvent
+                  );
+  if (EFI_ERROR (Status)) {
+    return ;
+  }
+
+  Status = gBS->CreateEvent (
+                  EFI_EVENT_SIGNAL_EXIT_BOOT_SERVICES,
+                  EFI_TPL_NOTIFY,
+                  SerialExitBootServices,
+                  NULL,
+                  &mSerialExitBootServicesEvent
+                  );
+  if (EFI_ERROR (Status)) {
+    gBS->CloseEvent (mSerialDrainEvent);
+    return ;
+  }
+
+  Status = gBS->SetTimer (mSerialDrainEvent, TimerPeriodic, SERIAL_DRAIN_PERIOD);
+  if (EFI_ERROR (Status)) {
+    gBS->CloseEvent (mSerialDrainEvent);
+    gBS->CloseEvent (mSerialExitBootServicesEvent);
+    return ;
+  }
+
+  mSerialDeferred = TRUE;
 }
 
 VOID
@@ -2257,8 +2486,10 @@ Returns:
   VA_LIST Marker;
   UINT32  ErrorLevel;
   UINTN   CharCount;
+  BOOLEAN Flush;
 
   Buffer[0] = '\0';
+  Flush     = (BOOLEAN) ((CodeType & EFI_STATUS_CODE_TYPE_MASK) == EFI_ERROR_CODE);
 
   if (ReportStatusCodeExtractAssertInfo (CodeType, Value, Data, &Filename, &Description, &LineNumber)) {
     //
@@ -2279,6 +2510,10 @@ Returns:
     //
     AvSPrint (Buffer, EFI_STATUS_CODE_DATA_MAX_SIZE, Format, Marker);
 
+    if ((ErrorLevel & EFI_D_ERROR) != 0) {
+      Flush = TRUE;
+    }
+
   } else if ((CodeType & EFI_STATUS_CODE_TYPE_MASK) == EFI_ERROR_CODE) {
     //
     // Process Errors
@@ -2315,9 +2550,11 @@ Returns:
 
   if (Buffer[0] != '\0') {
     //
-    // Callout to platform Lib function to do print.
+    // Queue the text for the UART. Errors, EFI_D_ERROR messages and
+    // ASSERT ()s are written out before returning, because the caller may
+    // never get to drain them.
     //
-    DebugSerialPrint (Buffer);
+    SerialOutput (Buffer, Flush);
   }
   //
   // Debug code to display human readable code information.
@@ -2369,7 +2606,7 @@ Returns:
         Instance
         );
 
-      DebugSerialPrint (Buffer);
+      SerialOutput (Buffer, TRUE);
     }
   }
 #endif
@@ -64,6 +64,10 @@ Abstract:
 #define LSR_TXRDY 0x20
 #define LSR_RXDA  0x01
 #define DLAB      0x01
+#define FCR_FIFO_ENABLE 0x01
+#define FCR_RX_RESET    0x02
+#define FCR_TX_RESET    0x04
+#define EIR_FIFO_MASK   0xC0
 
 //
 // Globals for Serial Port settings
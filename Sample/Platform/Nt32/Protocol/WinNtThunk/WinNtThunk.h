@@ -606,6 +606,20 @@ DWORD
   VOID
   );
 
+typedef
+WINBASEAPI
+BOOL
+(WINAPI *WinNtQueryPerformanceCounter) (
+  LARGE_INTEGER *PerformanceCount
+  );
+
+typedef
+WINBASEAPI
+BOOL
+(WINAPI *WinNtQueryPerformanceFrequency) (
+  LARGE_INTEGER *Frequency
+  );
+
 typedef
 WINBASEAPI
 HMODULE
@@ -1267,6 +1281,12 @@ typedef struct _EFI_WIN_NT_THUNK_PROTOCOL {
   WinNtHeapAlloc                      HeapAlloc;
   WinNtHeapFree                       HeapFree;
 
+  //
+  // Win32 high resolution monotonic counter
+  //
+  WinNtQueryPerformanceCounter        QueryPerformanceCounter;
+  WinNtQueryPerformanceFrequency      QueryPerformanceFrequency;
+
 } EFI_WIN_NT_THUNK_PROTOCOL;
 
 #endif
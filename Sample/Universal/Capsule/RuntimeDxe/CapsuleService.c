@@ -24,6 +24,162 @@ Abstract:
 #include EFI_GUID_DEFINITION(Capsule)
 
 
+VOID
+CapsuleSgStreamInit (
+  OUT CAPSULE_SG_STREAM       *Stream,
+  IN  EFI_PHYSICAL_ADDRESS    ScatterGatherList
+  )
+/*++
+
+Routine Description:
+
+  Start reading the capsules described by a scatter-gather list.
+
+Arguments:
+
+  Stream                         The stream to initialize
+  ScatterGatherList              Physical address of the first block descriptor
+  
+Returns:
+
+  None
+
+--*/
+{
+  Stream->Descriptor  = (EFI_CAPSULE_BLOCK_DESCRIPTOR *) (UINTN) ScatterGatherList;
+  Stream->Data        = Stream->Descriptor->Union.DataBlock;
+  Stream->Remaining   = Stream->Descriptor->Length;
+}
+
+EFI_STATUS
+CapsuleSgStreamRead (
+  IN OUT CAPSULE_SG_STREAM    *Stream,
+  OUT    VOID                 *Buffer OPTIONAL,
+  IN     UINT64               Length
+  )
+/*++
+
+Routine Description:
+
+  Read, or skip, the next bytes of a scatter-gather list. Data blocks are
+  consumed in place, so only the bytes copied to Buffer are ever touched.
+
+Arguments:
+
+  Stream                         The stream to read from
+  Buffer                         Receives the data, NULL to skip it
+  Length                         Number of bytes to read
+  
+Returns:
+
+  EFI_SUCCESS                    The bytes were read.
+  EFI_INVALID_PARAMETER          The list ends, or loops, before Length bytes.
+  
+--*/
+{
+  UINT64  Chunk;
+  UINTN   Continuations;
+
+  Continuations = 0;
+  while (Length != 0) {
+    if (Stream->Remaining == 0) {
+      if (Stream->Descriptor->Length != 0) {
+        //
+        // Move on to the descriptor following this data block.
+        //
+        Stream->Descriptor++;
+      } else if (Stream->Descriptor->Union.ContinuationPointer != 0) {
+        //
+        // A zero length descriptor chains to another descriptor array.
+        //
+        if (++Continuations > MAX_CAPSULE_SG_CONTINUATIONS) {
+          return EFI_INVALID_PARAMETER;
+        }
+
+        Stream->Descriptor = (EFI_CAPSULE_BLOCK_DESCRIPTOR *) (UINTN) Stream->Descriptor->Union.ContinuationPointer;
+      } else {
+        //
+        // End of the list.
+        //
+        return EFI_INVALID_PARAMETER;
+      }
+
+      Stream->Data      = Stream->Descriptor->Union.DataBlock;
+      Stream->Remaining = Stream->Descriptor->Length;
+      continue;
+    }
+
+    Continuations = 0;
+    Chunk         = (Length < Stream->Remaining) ? Length : Stream->Remaining;
+    if (Buffer != NULL) {
+      EfiCopyMem (Buffer, (VOID *) (UINTN) Stream->Data, (UINTN) Chunk);
+      Buffer = (UINT8 *) Buffer + (UINTN) Chunk;
+    }
+
+    Stream->Data      += Chunk;
+    Stream->Remaining -= Chunk;
+    Length            -= Chunk;
+  }
+
+  return EFI_SUCCESS;
+}
+
+STATIC
+EFI_STATUS
+ValidateScatterGatherList (
+  IN EFI_CAPSULE_HEADER      **CapsuleHeaderArray,
+  IN UINTN                   CapsuleCount,
+  IN EFI_PHYSICAL_ADDRESS    ScatterGatherList
+  )
+/*++
+
+Routine Description:
+
+  Check that a scatter-gather list describes the capsules of 
+  CapsuleHeaderArray, in order. Only the capsule headers are read out of 
+  the list and the capsule bodies are skipped, so a bad list is caught 
+  before the system is reset without coalescing anything.
+
+Arguments:
+
+  CapsuleHeaderArray             A array of pointers to capsule headers passed in
+  CapsuleCount                   The number of capsule
+  ScatterGatherList              Physical address of datablock list points to capsule
+  
+Returns:
+
+  EFI_SUCCESS                    The list matches the capsules.
+  EFI_INVALID_PARAMETER          The list does not match the capsules.
+  
+--*/
+{
+  EFI_STATUS          Status;
+  CAPSULE_SG_STREAM   Stream;
+  EFI_CAPSULE_HEADER  CapsuleHeader;
+  UINTN               ArrayNumber;
+
+  CapsuleSgStreamInit (&Stream, ScatterGatherList);
+
+  for (ArrayNumber = 0; ArrayNumber < CapsuleCount; ArrayNumber++) {
+    Status = CapsuleSgStreamRead (&Stream, &CapsuleHeader, sizeof (EFI_CAPSULE_HEADER));
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+
+    if ((EfiCompareMem (&CapsuleHeader, CapsuleHeaderArray[ArrayNumber], sizeof (EFI_CAPSULE_HEADER)) != 0) ||
+        (CapsuleHeader.CapsuleImageSize < sizeof (EFI_CAPSULE_HEADER))) {
+      return EFI_INVALID_PARAMETER;
+    }
+
+    Status = CapsuleSgStreamRead (&Stream, NULL, CapsuleHeader.CapsuleImageSize - sizeof (EFI_CAPSULE_HEADER));
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+  }
+
+  return EFI_SUCCESS;
+}
+
 EFI_STATUS
 EFIAPI
 UpdateCapsule (
@@ -105,6 +261,17 @@ Returns:
     return EFI_UNSUPPORTED;
   }
 
+  //
+  // The list can only be followed while physical addresses are still
+  // mapped, that is before SetVirtualAddressMap().
+  //
+  if (!EfiGoneVirtual ()) {
+    Status = ValidateScatterGatherList (CapsuleHeaderArray, CapsuleCount, ScatterGatherList);
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+  }
+
   //
   // ScatterGatherList is only referenced if the capsules are defined to persist across
   // system reset. Set its value into NV storage to let pre-boot driver to pick it up 
@@ -26,6 +26,22 @@ Abstract:
 #include "EfiCapsule.h"
 #include "EfiRuntimeLib.h"
 
+//
+// Reads a capsule straight out of its scatter-gather list, without first
+// coalescing it into a contiguous buffer.
+//
+typedef struct {
+  EFI_CAPSULE_BLOCK_DESCRIPTOR  *Descriptor;
+  EFI_PHYSICAL_ADDRESS          Data;
+  UINT64                        Remaining;
+} CAPSULE_SG_STREAM;
+
+//
+// Number of continuation descriptors that may be followed in a row before
+// the list is considered to loop.
+//
+#define MAX_CAPSULE_SG_CONTINUATIONS  0x100
+
 
 EFI_STATUS
 EFIAPI
@@ -59,6 +75,18 @@ LaunchCapsule (
   OUT BOOLEAN                *NeedReset
   );
 
+VOID
+CapsuleSgStreamInit (
+  OUT CAPSULE_SG_STREAM       *Stream,
+  IN  EFI_PHYSICAL_ADDRESS    ScatterGatherList
+  );
+
+EFI_STATUS
+CapsuleSgStreamRead (
+  IN OUT CAPSULE_SG_STREAM    *Stream,
+  OUT    VOID                 *Buffer OPTIONAL,
+  IN     UINT64               Length
+  );
 
 BOOLEAN
 EFIAPI
@@ -43,11 +43,228 @@ FindFilterDriverByEvent (
 STATIC
 EFI_DATA_RECORD_HEADER  *
 GetNextDataRecord (
-  IN  EFI_LIST_ENTRY      *Head,
+  IN  DATA_HUB_INSTANCE   *Private,
   IN  UINT64              ClassFilter,
   IN OUT  UINT64          *PtrCurrentMTC
   );
 
+STATIC
+VOID *
+DataHubAllocateEntry (
+  IN  DATA_HUB_INSTANCE   *Private,
+  IN  UINTN               Size
+  )
+/*++
+
+Routine Description:
+  Carve a data log entry out of the current arena, starting a new arena
+   when the current one is exhausted. Entries are never freed.
+
+Arguments:
+
+  Private - Data hub instance, DataLock must be held.
+
+  Size    - Number of bytes required.
+
+Returns: 
+
+  Pointer to the zeroed entry, or NULL if out of resources.
+
+--*/
+{
+  EFI_STATUS  Status;
+  UINT8       *Buffer;
+
+  Size = (Size + sizeof (UINT64) - 1) & ~(sizeof (UINT64) - 1);
+
+  if (Size > Private->ArenaRemaining) {
+    if (Size > DATA_HUB_ARENA_SIZE / 4) {
+      //
+      // Large records get their own allocation so they do not waste
+      //  the tail of an arena.
+      //
+      Status = gBS->AllocatePool (EfiBootServicesData, Size, (VOID **) &Buffer);
+      if (EFI_ERROR (Status)) {
+        return NULL;
+      }
+
+      EfiZeroMem (Buffer, Size);
+      return Buffer;
+    }
+
+    Status = gBS->AllocatePool (EfiBootServicesData, DATA_HUB_ARENA_SIZE, (VOID **) &Buffer);
+    if (EFI_ERROR (Status)) {
+      return NULL;
+    }
+
+    Private->ArenaFree      = Buffer;
+    Private->ArenaRemaining = DATA_HUB_ARENA_SIZE;
+  }
+
+  Buffer                   = Private->ArenaFree;
+  Private->ArenaFree      += Size;
+  Private->ArenaRemaining -= Size;
+
+  EfiZeroMem (Buffer, Size);
+  return Buffer;
+}
+
+STATIC
+BOOLEAN
+DataHubIndexAppend (
+  IN  DATA_HUB_INDEX      *Index,
+  IN  EFI_DATA_ENTRY      *LogEntry
+  )
+/*++
+
+Routine Description:
+  Append a data log entry to an index. The entry must have the highest
+   LogMonotonicCount of all entries in the index.
+
+Arguments:
+
+  Index     - Index to update, DataLock must be held.
+
+  LogEntry  - Entry to append.
+
+Returns: 
+
+  TRUE  - The entry was appended.
+
+  FALSE - The index is full or a chunk could not be allocated.
+
+--*/
+{
+  UINTN   ChunkIndex;
+  VOID    **Chunk;
+
+  ChunkIndex = Index->Count / DATA_HUB_INDEX_CHUNK_SIZE;
+  if (ChunkIndex >= DATA_HUB_INDEX_CHUNK_COUNT) {
+    return FALSE;
+  }
+
+  if (Index->Chunk[ChunkIndex] == NULL) {
+    Chunk = EfiLibAllocatePool (DATA_HUB_INDEX_CHUNK_SIZE * sizeof (VOID *));
+    if (Chunk == NULL) {
+      return FALSE;
+    }
+
+    Index->Chunk[ChunkIndex] = Chunk;
+  }
+  //
+  // Publish the entry before the count so a reader never sees an empty slot.
+  //
+  Index->Chunk[ChunkIndex][Index->Count % DATA_HUB_INDEX_CHUNK_SIZE] = LogEntry;
+  Index->Count++;
+
+  return TRUE;
+}
+
+STATIC
+EFI_DATA_ENTRY *
+DataHubIndexEntry (
+  IN  DATA_HUB_INDEX      *Index,
+  IN  UINTN               Position
+  )
+{
+  return (EFI_DATA_ENTRY *) Index->Chunk[Position / DATA_HUB_INDEX_CHUNK_SIZE][Position % DATA_HUB_INDEX_CHUNK_SIZE];
+}
+
+STATIC
+EFI_DATA_ENTRY *
+DataHubIndexFindNext (
+  IN  DATA_HUB_INDEX      *Index,
+  IN  UINT64              MonotonicCount
+  )
+/*++
+
+Routine Description:
+  Binary search an index for the first entry whose LogMonotonicCount is
+   greater than MonotonicCount.
+
+Arguments:
+
+  Index           - Index to search.
+
+  MonotonicCount  - Records up to and including this MTC are skipped.
+
+Returns: 
+
+  The entry found, or NULL if there is none.
+
+--*/
+{
+  UINTN           Low;
+  UINTN           High;
+  UINTN           Middle;
+  EFI_DATA_ENTRY  *LogEntry;
+
+  Low   = 0;
+  High  = Index->Count;
+  while (Low < High) {
+    Middle    = Low + (High - Low) / 2;
+    LogEntry  = DataHubIndexEntry (Index, Middle);
+    if (LogEntry->Record->LogMonotonicCount <= MonotonicCount) {
+      Low = Middle + 1;
+    } else {
+      High = Middle;
+    }
+  }
+
+  if (Low == Index->Count) {
+    return NULL;
+  }
+
+  return DataHubIndexEntry (Index, Low);
+}
+
+STATIC
+EFI_DATA_ENTRY *
+FindNextDataEntry (
+  IN  DATA_HUB_INSTANCE   *Private,
+  IN  UINT64              ClassFilter,
+  IN  UINT64              MonotonicCount
+  )
+/*++
+
+Routine Description:
+  Find the first data log entry after MonotonicCount whose class is in
+   ClassFilter, using the class indexes.
+
+Arguments:
+
+  Private         - Data hub instance.
+
+  ClassFilter     - Classes to match, a subset of DATA_HUB_CLASS_MASK.
+
+  MonotonicCount  - Records up to and including this MTC are skipped.
+
+Returns: 
+
+  The entry found, or NULL if there is none.
+
+--*/
+{
+  UINTN           Class;
+  EFI_DATA_ENTRY  *LogEntry;
+  EFI_DATA_ENTRY  *Found;
+
+  Found = NULL;
+  for (Class = 0; Class < DATA_HUB_CLASS_COUNT; Class++) {
+    if ((ClassFilter & (UINT64) (1 << Class)) == 0) {
+      continue;
+    }
+
+    LogEntry = DataHubIndexFindNext (&Private->ClassIndex[Class], MonotonicCount);
+    if ((LogEntry != NULL) &&
+        ((Found == NULL) || (LogEntry->Record->LogMonotonicCount < Found->Record->LogMonotonicCount))) {
+      Found = LogEntry;
+    }
+  }
+
+  return Found;
+}
+
 EFI_STATUS
 EFIAPI
 DataHubLogData (
@@ -96,6 +313,7 @@ Returns:
   DATA_HUB_FILTER_DRIVER  *FilterEntry;
   EFI_LIST_ENTRY          *Link;
   EFI_LIST_ENTRY          *Head;
+  UINTN                   Class;
   EFI_GUID                ZeroGuid  = { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 };
 
   Private = DATA_HUB_INSTANCE_FROM_THIS (This);
@@ -122,14 +340,12 @@ Returns:
     return Status;
   }
 
-  Status = gBS->AllocatePool (EfiBootServicesData, TotalSize, (VOID **) &LogEntry);
-  if (EFI_ERROR (Status)) {
+  LogEntry = DataHubAllocateEntry (Private, TotalSize);
+  if (LogEntry == NULL) {
     EfiReleaseLock (&Private->DataLock);
     return EFI_OUT_OF_RESOURCES;
   }
 
-  EfiZeroMem (LogEntry, TotalSize);
-
   Record  = (EFI_DATA_RECORD_HEADER *) (LogEntry + 1);
   Raw     = (VOID *) (Record + 1);
 
@@ -156,9 +372,17 @@ Returns:
   LogEntry->Signature   = EFI_DATA_ENTRY_SIGNATURE;
   LogEntry->Record      = Record;
   LogEntry->RecordSize  = sizeof (EFI_DATA_ENTRY) + RawDataSize;
+  EfiCopyMem (Raw, RawData, RawDataSize);
+
   InsertTailList (&Private->DataListHead, &LogEntry->Link);
 
-  EfiCopyMem (Raw, RawData, RawDataSize);
+  for (Class = 0; Class < DATA_HUB_CLASS_COUNT; Class++) {
+    if ((DataRecordClass & (UINT64) (1 << Class)) != 0) {
+      if (!DataHubIndexAppend (&Private->ClassIndex[Class], LogEntry)) {
+        Private->IndexValid = FALSE;
+      }
+    }
+  }
 
   EfiReleaseLock (&Private->DataLock);
 
@@ -265,7 +489,7 @@ Returns:
         // The GetNextMonotonicCount field remembers the last value from the previous time.
         // But we already processed this vaule, so we need to find the next one.
         //
-        *Record         = GetNextDataRecord (&Private->DataListHead, ClassFilter, &FilterMonotonicCount);
+        *Record         = GetNextDataRecord (Private, ClassFilter, &FilterMonotonicCount);
         *MonotonicCount = FilterMonotonicCount;
         if (FilterMonotonicCount == 0) {
           //
@@ -279,7 +503,7 @@ Returns:
   //
   // Return the record
   //
-  *Record = GetNextDataRecord (&Private->DataListHead, ClassFilter, MonotonicCount);
+  *Record = GetNextDataRecord (Private, ClassFilter, MonotonicCount);
   if (*Record == NULL) {
     return EFI_NOT_FOUND;
   }
@@ -502,19 +726,23 @@ Returns:
 STATIC
 EFI_DATA_RECORD_HEADER *
 GetNextDataRecord (
-  IN  EFI_LIST_ENTRY      *Head,
+  IN  DATA_HUB_INSTANCE   *Private,
   IN  UINT64              ClassFilter,
   IN OUT  UINT64          *PtrCurrentMTC
   )
 /*++
 
 Routine Description:
-  Search the Head doubly linked list for the passed in MTC. Return the 
-   matching element in Head and the MTC on the next entry.
+  Search the data log for the passed in MTC. Return the matching record
+   and the MTC of the next record in ClassFilter.
+
+  The class indexes are used when ClassFilter only contains the standard
+   record classes, making this a pair of binary searches. Otherwise the
+   data log linked list is walked.
 
 Arguments:
 
-  Head          - Head of Data Log linked list.
+  Private       - Data hub instance.
 
   ClassFilter   - Only match the MTC if it is in the same Class as the
                   ClassFilter.
@@ -530,6 +758,7 @@ Returns:
 
 --*/
 {
+  EFI_LIST_ENTRY          *Head;
   EFI_DATA_ENTRY          *LogEntry;
   EFI_LIST_ENTRY          *Link;
   BOOLEAN                 ReturnFirstEntry;
@@ -541,6 +770,26 @@ Returns:
   //
   ReturnFirstEntry  = (BOOLEAN) (*PtrCurrentMTC == 0);
 
+  if (Private->IndexValid && ((ClassFilter & ~DATA_HUB_CLASS_MASK) == 0)) {
+    if (ReturnFirstEntry) {
+      LogEntry = FindNextDataEntry (Private, ClassFilter, 0);
+    } else {
+      LogEntry = FindNextDataEntry (Private, ClassFilter, *PtrCurrentMTC - 1);
+      if ((LogEntry != NULL) && (LogEntry->Record->LogMonotonicCount != *PtrCurrentMTC)) {
+        LogEntry = NULL;
+      }
+    }
+
+    if (LogEntry == NULL) {
+      return NULL;
+    }
+
+    NextLogEntry    = FindNextDataEntry (Private, ClassFilter, LogEntry->Record->LogMonotonicCount);
+    *PtrCurrentMTC  = (NextLogEntry == NULL) ? 0 : NextLogEntry->Record->LogMonotonicCount;
+    return LogEntry->Record;
+  }
+
+  Head              = &Private->DataListHead;
   Record            = NULL;
   for (Link = Head->ForwardLink; Link != Head; Link = Link->ForwardLink) {
     LogEntry = DATA_ENTRY_FROM_LINK (Link);
@@ -629,6 +878,7 @@ Returns:
   //
   InitializeListHead (&mPrivateData.DataListHead);
   InitializeListHead (&mPrivateData.FilterDriverListHead);
+  mPrivateData.IndexValid = TRUE;
 
   EfiInitializeLock (&mPrivateData.DataLock, EFI_TPL_NOTIFY);
 
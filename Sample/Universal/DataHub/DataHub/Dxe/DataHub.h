@@ -32,6 +32,31 @@ Abstract:
 #include EFI_GUID_DEFINITION (StatusCode)
 #include EFI_GUID_DEFINITION (StatusCodeDataTypeId)
 
+//
+// Data records are indexed by class so GetNextRecord () can find a record
+// and its successor with a binary search instead of walking the whole log.
+// An index is a directory of fixed size chunks of EFI_DATA_ENTRY pointers
+// in ascending order of LogMonotonicCount. Chunks are never moved, so a
+// reader interrupted by DataHubLogData () never sees a stale array.
+//
+#define DATA_HUB_CLASS_COUNT        4
+#define DATA_HUB_CLASS_MASK         (EFI_DATA_RECORD_CLASS_DEBUG | \
+                                     EFI_DATA_RECORD_CLASS_ERROR | \
+                                     EFI_DATA_RECORD_CLASS_DATA | \
+                                     EFI_DATA_RECORD_CLASS_PROGRESS_CODE)
+#define DATA_HUB_INDEX_CHUNK_SIZE   512
+#define DATA_HUB_INDEX_CHUNK_COUNT  256
+
+typedef struct {
+  UINTN                 Count;
+  VOID                  **Chunk[DATA_HUB_INDEX_CHUNK_COUNT];
+} DATA_HUB_INDEX;
+
+//
+// EFI_DATA_ENTRY structures are carved out of arenas of this size.
+//
+#define DATA_HUB_ARENA_SIZE         0x10000
+
 #define DATA_HUB_INSTANCE_SIGNATURE EFI_SIGNATURE_32 ('D', 'H', 'u', 'b')
 typedef struct {
   UINT32                Signature;
@@ -70,6 +95,19 @@ typedef struct {
   //
   EFI_LIST_ENTRY        FilterDriverListHead;
 
+  //
+  // Per class indexes of DataListHead. If any index could not be updated,
+  //  IndexValid is cleared and GetNextRecord () walks DataListHead.
+  //
+  BOOLEAN               IndexValid;
+  DATA_HUB_INDEX        ClassIndex[DATA_HUB_CLASS_COUNT];
+
+  //
+  // Unused space of the current record arena.
+  //
+  UINT8                 *ArenaFree;
+  UINTN                 ArenaRemaining;
+
 } DATA_HUB_INSTANCE;
 
 #define DATA_HUB_INSTANCE_FROM_THIS(this) CR (this, DATA_HUB_INSTANCE, DataHub, DATA_HUB_INSTANCE_SIGNATURE)
@@ -43,67 +43,47 @@ Notes:
 // In write function, we should check the target range to prevent the user
 // from writing Spare block and Working space directly.
 //
-//
-// Fault Tolerant Write Protocol API
-//
+STATIC
 EFI_STATUS
-EFIAPI
-FtwLiteWrite (
-  IN EFI_FTW_LITE_PROTOCOL                 *This,
-  IN EFI_HANDLE                            FvbHandle,
+FtwLiteAllocateRecord (
+  IN EFI_FTW_LITE_DEVICE                   *FtwLiteDevice,
+  IN EFI_FIRMWARE_VOLUME_BLOCK_PROTOCOL    *Fvb,
   IN EFI_LBA                               Lba,
   IN UINTN                                 Offset,
-  IN OUT UINTN                             *NumBytes,
-  IN VOID                                  *Buffer
+  IN UINTN                                 NumBytes
   )
 /*++
 
 Routine Description:
-    Starts a target block update. This function will record data about write 
-    in fault tolerant storage and will complete the write in a recoverable 
-    manner, ensuring at all times that either the original contents or 
-    the modified contents are available.
+    Allocate the next write record in the work space and write the target
+    information of a spare block cycle into it.
 
 Arguments:
-    This             - Calling context
-    FvbHandle        - The handle of FVB protocol that provides services for 
-                       reading, writing, and erasing the target block.
+    FtwLiteDevice    - The private data of FTW_LITE driver
+    Fvb              - The FVB protocol of the target block
     Lba              - The logical block address of the target block.  
     Offset           - The offset within the target block to place the data.
     NumBytes         - The number of bytes to write to the target block.
-    Buffer           - The data to write.
 
 Returns:
-    EFI_SUCCESS          - The function completed successfully
-    EFI_BAD_BUFFER_SIZE  - The write would span a target block, which is not 
-                           a valid action.
-    EFI_ACCESS_DENIED    - No writes have been allocated.
-    EFI_NOT_FOUND        - Cannot find FVB by handle.
-    EFI_OUT_OF_RESOURCES - Cannot allocate memory.
+    EFI_SUCCESS          - The record was written to the work space
+    EFI_BAD_BUFFER_SIZE  - The write would span the spare area
+    EFI_ACCESS_DENIED    - The last write has not been completed.
     EFI_ABORTED          - The function could not complete successfully.
 
 --*/
 {
   EFI_STATUS                          Status;
-  EFI_FTW_LITE_DEVICE                 *FtwLiteDevice;
   EFI_FTW_LITE_RECORD                 *Record;
-  EFI_FIRMWARE_VOLUME_BLOCK_PROTOCOL  *Fvb;
   EFI_PHYSICAL_ADDRESS                FvbPhysicalAddress;
   UINTN                               MyLength;
   UINTN                               MyOffset;
-  UINTN                               MyBufferSize;
-  UINT8                               *MyBuffer;
-  UINTN                               SpareBufferSize;
-  UINT8                               *SpareBuffer;
-  UINTN                               Index;
-  UINT8                               *Ptr;
   EFI_DEV_PATH_PTR                    DevPtr;
 
   //
   // Refresh work space and get last record
   //
-  FtwLiteDevice = FTW_LITE_CONTEXT_FROM_THIS (This);
-  Status        = WorkSpaceRefresh (FtwLiteDevice);
+  Status = WorkSpaceRefresh (FtwLiteDevice);
   if (EFI_ERROR (Status)) {
     return EFI_ABORTED;
   }
@@ -129,7 +109,7 @@ Returns:
   //
   // Check if the input data can fit within the target block
   //
-  if ((Offset +*NumBytes) > FtwLiteDevice->SpareAreaLength) {
+  if ((Offset + NumBytes) > FtwLiteDevice->SpareAreaLength) {
     return EFI_BAD_BUFFER_SIZE;
   }
   //
@@ -143,13 +123,6 @@ Returns:
     }
   }
   //
-  // Get the FVB protocol by handle
-  //
-  Status = FtwGetFvbByHandle (FvbHandle, &Fvb);
-  if (EFI_ERROR (Status)) {
-    return EFI_NOT_FOUND;
-  }
-  //
   // Allocate a write record in workspace.
   // Update Header->WriteAllocated as VALID
   //
@@ -183,13 +156,13 @@ Returns:
 
   DevPtr.MemMap->MemoryType       = EfiMemoryMappedIO;
   DevPtr.MemMap->StartingAddress  = FvbPhysicalAddress;
-  DevPtr.MemMap->EndingAddress    = FvbPhysicalAddress +*NumBytes;
+  DevPtr.MemMap->EndingAddress    = FvbPhysicalAddress + NumBytes;
   //
   // ignored!
   //
   Record->Lba       = Lba;
   Record->Offset    = Offset;
-  Record->NumBytes  = *NumBytes;
+  Record->NumBytes  = NumBytes;
 
   //
   // Write the record to the work space.
@@ -207,6 +180,235 @@ Returns:
   if (EFI_ERROR (Status)) {
     return EFI_ABORTED;
   }
+
+  return EFI_SUCCESS;
+}
+
+STATIC
+EFI_STATUS
+FtwLiteReadSpareArea (
+  IN EFI_FTW_LITE_DEVICE                   *FtwLiteDevice,
+  IN EFI_FIRMWARE_VOLUME_BLOCK_PROTOCOL    *Fvb,
+  IN EFI_LBA                               Lba,
+  OUT UINT8                                *Buffer
+  )
+/*++
+
+Routine Description:
+    Read NumberOfSpareBlock blocks starting at Lba into a spare-area-sized buffer.
+
+Arguments:
+    FtwLiteDevice    - The private data of FTW_LITE driver
+    Fvb              - The FVB protocol to read from
+    Lba              - The first logical block to read
+    Buffer           - Buffer of SpareAreaLength bytes
+
+Returns:
+    EFI_SUCCESS      - The blocks were read
+    EFI_ABORTED      - The function could not complete successfully.
+
+--*/
+{
+  EFI_STATUS  Status;
+  UINTN       Index;
+  UINTN       MyLength;
+  UINT8       *Ptr;
+
+  Ptr = Buffer;
+  for (Index = 0; Index < FtwLiteDevice->NumberOfSpareBlock; Index += 1) {
+    MyLength  = FtwLiteDevice->SizeOfSpareBlock;
+    Status    = Fvb->Read (Fvb, Lba + Index, 0, &MyLength, Ptr);
+    if (EFI_ERROR (Status)) {
+      return EFI_ABORTED;
+    }
+
+    Ptr += MyLength;
+  }
+
+  return EFI_SUCCESS;
+}
+
+STATIC
+EFI_STATUS
+FtwLiteWriteSpareArea (
+  IN EFI_FTW_LITE_DEVICE                   *FtwLiteDevice,
+  IN UINT8                                 *Buffer
+  )
+/*++
+
+Routine Description:
+    Erase the spare block and write a spare-area-sized buffer into it.
+
+Arguments:
+    FtwLiteDevice    - The private data of FTW_LITE driver
+    Buffer           - Buffer of SpareAreaLength bytes
+
+Returns:
+    EFI_SUCCESS      - The spare block was written
+    EFI_ABORTED      - The function could not complete successfully.
+
+--*/
+{
+  EFI_STATUS  Status;
+  UINTN       Index;
+  UINTN       MyLength;
+  UINT8       *Ptr;
+
+  Status  = FtwEraseSpareBlock (FtwLiteDevice);
+  Ptr     = Buffer;
+  for (Index = 0; Index < FtwLiteDevice->NumberOfSpareBlock; Index += 1) {
+    MyLength = FtwLiteDevice->SizeOfSpareBlock;
+    Status = FtwLiteDevice->FtwBackupFvb->Write (
+                                            FtwLiteDevice->FtwBackupFvb,
+                                            FtwLiteDevice->FtwSpareLba + Index,
+                                            0,
+                                            &MyLength,
+                                            Ptr
+                                            );
+    if (EFI_ERROR (Status)) {
+      return EFI_ABORTED;
+    }
+
+    Ptr += MyLength;
+  }
+
+  return EFI_SUCCESS;
+}
+
+STATIC
+EFI_STATUS
+FtwLiteCommitSpareArea (
+  IN EFI_FTW_LITE_DEVICE                   *FtwLiteDevice,
+  IN EFI_FIRMWARE_VOLUME_BLOCK_PROTOCOL    *Fvb,
+  IN UINT8                                 *Buffer
+  )
+/*++
+
+Routine Description:
+    Complete the spare block cycle of the last allocated record: write the
+    new target content to the spare block, mark the record SpareCompleted
+    and flush the spare block to the target.
+
+Arguments:
+    FtwLiteDevice    - The private data of FTW_LITE driver
+    Fvb              - The FVB protocol of the target block
+    Buffer           - New content of the whole target area, SpareAreaLength bytes
+
+Returns:
+    EFI_SUCCESS      - The target was updated
+    EFI_ABORTED      - The function could not complete successfully.
+
+--*/
+{
+  EFI_STATUS          Status;
+  EFI_FTW_LITE_RECORD *Record;
+  UINTN               MyOffset;
+
+  Status = FtwLiteWriteSpareArea (FtwLiteDevice, Buffer);
+  if (EFI_ERROR (Status)) {
+    return EFI_ABORTED;
+  }
+
+  //
+  // Set the SpareCompleteD in the FTW record,
+  //
+  Record   = FtwLiteDevice->FtwLastRecord;
+  MyOffset = (UINT8 *) Record - FtwLiteDevice->FtwWorkSpace;
+  Status = FtwUpdateFvState (
+            FtwLiteDevice->FtwFvBlock,
+            FtwLiteDevice->FtwWorkSpaceLba,
+            FtwLiteDevice->FtwWorkSpaceBase + MyOffset,
+            SPARE_COMPLETED
+            );
+  if (EFI_ERROR (Status)) {
+    return EFI_ABORTED;
+  }
+
+  Record->SpareCompleted = FTW_VALID_STATE;
+
+  //
+  //  Since the content has already backuped in spare block, the write is
+  //  guaranteed to be completed with fault tolerant manner.
+  //
+  Status = FtwWriteRecord (FtwLiteDevice, Fvb);
+  if (EFI_ERROR (Status)) {
+    return EFI_ABORTED;
+  }
+
+  Record++;
+  FtwLiteDevice->FtwLastRecord = Record;
+  return EFI_SUCCESS;
+}
+
+//
+// Fault Tolerant Write Protocol API
+//
+EFI_STATUS
+EFIAPI
+FtwLiteWrite (
+  IN EFI_FTW_LITE_PROTOCOL                 *This,
+  IN EFI_HANDLE                            FvbHandle,
+  IN EFI_LBA                               Lba,
+  IN UINTN                                 Offset,
+  IN OUT UINTN                             *NumBytes,
+  IN VOID                                  *Buffer
+  )
+/*++
+
+Routine Description:
+    Starts a target block update. This function will record data about write 
+    in fault tolerant storage and will complete the write in a recoverable 
+    manner, ensuring at all times that either the original contents or 
+    the modified contents are available.
+
+Arguments:
+    This             - Calling context
+    FvbHandle        - The handle of FVB protocol that provides services for 
+                       reading, writing, and erasing the target block.
+    Lba              - The logical block address of the target block.  
+    Offset           - The offset within the target block to place the data.
+    NumBytes         - The number of bytes to write to the target block.
+    Buffer           - The data to write.
+
+Returns:
+    EFI_SUCCESS          - The function completed successfully
+    EFI_BAD_BUFFER_SIZE  - The write would span a target block, which is not 
+                           a valid action.
+    EFI_ACCESS_DENIED    - No writes have been allocated.
+    EFI_NOT_FOUND        - Cannot find FVB by handle.
+    EFI_OUT_OF_RESOURCES - Cannot allocate memory.
+    EFI_ABORTED          - The function could not complete successfully.
+
+--*/
+{
+  EFI_STATUS                          Status;
+  EFI_FTW_LITE_DEVICE                 *FtwLiteDevice;
+  EFI_FIRMWARE_VOLUME_BLOCK_PROTOCOL  *Fvb;
+  UINTN                               MyBufferSize;
+  UINT8                               *MyBuffer;
+  UINTN                               SpareBufferSize;
+  UINT8                               *SpareBuffer;
+
+  FtwLiteDevice = FTW_LITE_CONTEXT_FROM_THIS (This);
+
+  //
+  // Check if the input data can fit within the target block
+  //
+  if ((Offset +*NumBytes) > FtwLiteDevice->SpareAreaLength) {
+    return EFI_BAD_BUFFER_SIZE;
+  }
+  //
+  // Get the FVB protocol by handle
+  //
+  Status = FtwGetFvbByHandle (FvbHandle, &Fvb);
+  if (EFI_ERROR (Status)) {
+    return EFI_NOT_FOUND;
+  }
+
+  Status = FtwLiteAllocateRecord (FtwLiteDevice, Fvb, Lba, Offset, *NumBytes);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
   //
   // Record has been written to working block, then write data.
   //
@@ -230,22 +432,15 @@ Returns:
     // If target block falls into working block, we must follow the process of
     // updating working block.
     //
-    Ptr = MyBuffer;
-    for (Index = 0; Index < FtwLiteDevice->NumberOfSpareBlock; Index += 1) {
-      MyLength = FtwLiteDevice->SizeOfSpareBlock;
-      Status = FtwLiteDevice->FtwFvBlock->Read (
-                                            FtwLiteDevice->FtwFvBlock,
-                                            FtwLiteDevice->FtwWorkBlockLba + Index,
-                                            0,
-                                            &MyLength,
-                                            Ptr
-                                            );
-      if (EFI_ERROR (Status)) {
-        gBS->FreePool (MyBuffer);
-        return EFI_ABORTED;
-      }
-
-      Ptr += MyLength;
+    Status = FtwLiteReadSpareArea (
+               FtwLiteDevice,
+               FtwLiteDevice->FtwFvBlock,
+               FtwLiteDevice->FtwWorkBlockLba,
+               MyBuffer
+               );
+    if (EFI_ERROR (Status)) {
+      gBS->FreePool (MyBuffer);
+      return EFI_ABORTED;
     }
     //
     // Update Offset by adding the offset from the start LBA of working block to
@@ -255,17 +450,10 @@ Returns:
     ASSERT ((Offset +*NumBytes) <= FtwLiteDevice->SpareAreaLength);
 
   } else {
-
-    Ptr = MyBuffer;
-    for (Index = 0; Index < FtwLiteDevice->NumberOfSpareBlock; Index += 1) {
-      MyLength  = FtwLiteDevice->SizeOfSpareBlock;
-      Status    = Fvb->Read (Fvb, Lba + Index, 0, &MyLength, Ptr);
-      if (EFI_ERROR (Status)) {
-        gBS->FreePool (MyBuffer);
-        return EFI_ABORTED;
-      }
-
-      Ptr += MyLength;
+    Status = FtwLiteReadSpareArea (FtwLiteDevice, Fvb, Lba, MyBuffer);
+    if (EFI_ERROR (Status)) {
+      gBS->FreePool (MyBuffer);
+      return EFI_ABORTED;
     }
   }
   //
@@ -285,108 +473,38 @@ Returns:
     return EFI_OUT_OF_RESOURCES;
   }
 
-  Ptr = SpareBuffer;
-  for (Index = 0; Index < FtwLiteDevice->NumberOfSpareBlock; Index += 1) {
-    MyLength = FtwLiteDevice->SizeOfSpareBlock;
-    Status = FtwLiteDevice->FtwBackupFvb->Read (
-                                            FtwLiteDevice->FtwBackupFvb,
-                                            FtwLiteDevice->FtwSpareLba + Index,
-                                            0,
-                                            &MyLength,
-                                            Ptr
-                                            );
-    if (EFI_ERROR (Status)) {
-      gBS->FreePool (MyBuffer);
-      gBS->FreePool (SpareBuffer);
-      return EFI_ABORTED;
-    }
-
-    Ptr += MyLength;
-  }
-  //
-  // Write the memory buffer to spare block
-  // Don't forget to erase Flash first.
-  //
-  Status  = FtwEraseSpareBlock (FtwLiteDevice);
-  Ptr     = MyBuffer;
-  for (Index = 0; Index < FtwLiteDevice->NumberOfSpareBlock; Index += 1) {
-    MyLength = FtwLiteDevice->SizeOfSpareBlock;
-    Status = FtwLiteDevice->FtwBackupFvb->Write (
-                                            FtwLiteDevice->FtwBackupFvb,
-                                            FtwLiteDevice->FtwSpareLba + Index,
-                                            0,
-                                            &MyLength,
-                                            Ptr
-                                            );
-    if (EFI_ERROR (Status)) {
-      gBS->FreePool (MyBuffer);
-      gBS->FreePool (SpareBuffer);
-      return EFI_ABORTED;
-    }
-
-    Ptr += MyLength;
-  }
-  //
-  // Free MyBuffer
-  //
-  gBS->FreePool (MyBuffer);
-
-  //
-  // Set the SpareCompleteD in the FTW record,
-  //
-  MyOffset = (UINT8 *) Record - FtwLiteDevice->FtwWorkSpace;
-  Status = FtwUpdateFvState (
-            FtwLiteDevice->FtwFvBlock,
-            FtwLiteDevice->FtwWorkSpaceLba,
-            FtwLiteDevice->FtwWorkSpaceBase + MyOffset,
-            SPARE_COMPLETED
-            );
+  Status = FtwLiteReadSpareArea (
+             FtwLiteDevice,
+             FtwLiteDevice->FtwBackupFvb,
+             FtwLiteDevice->FtwSpareLba,
+             SpareBuffer
+             );
   if (EFI_ERROR (Status)) {
+    gBS->FreePool (MyBuffer);
     gBS->FreePool (SpareBuffer);
     return EFI_ABORTED;
   }
-
-  Record->SpareCompleted = FTW_VALID_STATE;
-
   //
-  //  Since the content has already backuped in spare block, the write is
-  //  guaranteed to be completed with fault tolerant manner.
+  // Write the memory buffer to spare block and flush it to the target.
   //
-  Status = FtwWriteRecord (FtwLiteDevice, Fvb);
+  Status = FtwLiteCommitSpareArea (FtwLiteDevice, Fvb, MyBuffer);
+  gBS->FreePool (MyBuffer);
   if (EFI_ERROR (Status)) {
     gBS->FreePool (SpareBuffer);
     return EFI_ABORTED;
   }
 
-  Record++;
-  FtwLiteDevice->FtwLastRecord = Record;
-
   //
   // Restore spare backup buffer into spare block , if no failure happened during FtwWrite.
   //
-  Status  = FtwEraseSpareBlock (FtwLiteDevice);
-  Ptr     = SpareBuffer;
-  for (Index = 0; Index < FtwLiteDevice->NumberOfSpareBlock; Index += 1) {
-    MyLength = FtwLiteDevice->SizeOfSpareBlock;
-    Status = FtwLiteDevice->FtwBackupFvb->Write (
-                                            FtwLiteDevice->FtwBackupFvb,
-                                            FtwLiteDevice->FtwSpareLba + Index,
-                                            0,
-                                            &MyLength,
-                                            Ptr
-                                            );
-    if (EFI_ERROR (Status)) {
-      gBS->FreePool (SpareBuffer);
-      return EFI_ABORTED;
-    }
-
-    Ptr += MyLength;
+  Status = FtwLiteWriteSpareArea (FtwLiteDevice, SpareBuffer);
+  gBS->FreePool (SpareBuffer);
+  if (EFI_ERROR (Status)) {
+    return EFI_ABORTED;
   }
   //
   // All success.
   //
-  gBS->FreePool (SpareBuffer);
-
   DEBUG (
     (EFI_D_FTW_LITE,
     "FtwLite: Write() success, (Lba:Offset)=(%lx:0x%x), NumBytes: 0x%x\n",
@@ -398,6 +516,189 @@ Returns:
   return EFI_SUCCESS;
 }
 
+EFI_STATUS
+EFIAPI
+FtwLiteWriteBatch (
+  IN EFI_FTW_LITE_BATCH_PROTOCOL           *This,
+  IN UINTN                                 RequestCount,
+  IN EFI_FTW_LITE_WRITE_REQUEST            *Requests
+  )
+/*++
+
+Routine Description:
+    Perform a list of fault tolerant writes with as few spare block cycles as
+    possible. Consecutive requests on the same FVB whose data falls within one
+    spare-area-sized window starting at the first request's LBA are merged
+    into that window and written with a single work space record and spare
+    block cycle. The spare block content is saved once before the first cycle
+    and restored once after the last one.
+
+    Each cycle is recorded and recovered exactly like a single Write(), so
+    after a power failure every window is either fully old or fully new.
+    Requests that target the working block are passed to Write() one by one.
+
+Arguments:
+    This             - Calling context
+    RequestCount     - Number of entries in Requests
+    Requests         - The writes to perform, in order
+
+Returns:
+    EFI_SUCCESS          - All writes completed successfully
+    EFI_INVALID_PARAMETER - Requests is NULL while RequestCount is not zero
+    EFI_BAD_BUFFER_SIZE  - A request would span the spare area
+    EFI_ACCESS_DENIED    - The last write has not been completed.
+    EFI_NOT_FOUND        - Cannot find FVB by handle.
+    EFI_OUT_OF_RESOURCES - Cannot allocate memory.
+    EFI_ABORTED          - The function could not complete successfully.
+
+--*/
+{
+  EFI_STATUS                          Status;
+  EFI_FTW_LITE_DEVICE                 *FtwLiteDevice;
+  EFI_FIRMWARE_VOLUME_BLOCK_PROTOCOL  *Fvb;
+  UINT8                               *MyBuffer;
+  UINT8                               *SpareBuffer;
+  UINTN                               First;
+  UINTN                               Last;
+  UINTN                               Index;
+  UINTN                               Position;
+  UINTN                               Start;
+  UINTN                               End;
+  UINTN                               NumBytes;
+
+  if (RequestCount == 0) {
+    return EFI_SUCCESS;
+  }
+
+  if (Requests == NULL) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  FtwLiteDevice = FTW_LITE_CONTEXT_FROM_BATCH_THIS (This);
+
+  for (Index = 0; Index < RequestCount; Index++) {
+    if ((Requests[Index].Offset + Requests[Index].NumBytes) > FtwLiteDevice->SpareAreaLength) {
+      return EFI_BAD_BUFFER_SIZE;
+    }
+  }
+
+  MyBuffer    = EfiLibAllocatePool (FtwLiteDevice->SpareAreaLength);
+  SpareBuffer = EfiLibAllocatePool (FtwLiteDevice->SpareAreaLength);
+  if ((MyBuffer == NULL) || (SpareBuffer == NULL)) {
+    Status = EFI_OUT_OF_RESOURCES;
+    goto Done;
+  }
+  //
+  // Try to keep the content of spare block
+  // Save spare block into a spare backup memory buffer (Sparebuffer)
+  //
+  Status = FtwLiteReadSpareArea (
+             FtwLiteDevice,
+             FtwLiteDevice->FtwBackupFvb,
+             FtwLiteDevice->FtwSpareLba,
+             SpareBuffer
+             );
+  if (EFI_ERROR (Status)) {
+    goto Done;
+  }
+
+  for (First = 0; First < RequestCount; First = Last) {
+    Status = FtwGetFvbByHandle (Requests[First].FvbHandle, &Fvb);
+    if (EFI_ERROR (Status)) {
+      Status = EFI_NOT_FOUND;
+      goto Done;
+    }
+
+    if (IsInWorkingBlock (FtwLiteDevice, Fvb, Requests[First].Lba)) {
+      NumBytes = Requests[First].NumBytes;
+      Status = FtwLiteWrite (
+                 &FtwLiteDevice->FtwLiteInstance,
+                 Requests[First].FvbHandle,
+                 Requests[First].Lba,
+                 Requests[First].Offset,
+                 &NumBytes,
+                 Requests[First].Buffer
+                 );
+      if (EFI_ERROR (Status)) {
+        goto Done;
+      }
+      Last = First + 1;
+      continue;
+    }
+    //
+    // Collect the following requests that fit in the window at Requests[First].Lba.
+    // A request on the working block ends the window, it must go through Write().
+    //
+    Start = Requests[First].Offset;
+    End   = Requests[First].Offset + Requests[First].NumBytes;
+    for (Last = First + 1; Last < RequestCount; Last++) {
+      if ((Requests[Last].FvbHandle != Requests[First].FvbHandle) ||
+          (Requests[Last].Lba < Requests[First].Lba) ||
+          (Requests[Last].Lba - Requests[First].Lba >= FtwLiteDevice->NumberOfSpareBlock) ||
+          IsInWorkingBlock (FtwLiteDevice, Fvb, Requests[Last].Lba)) {
+        break;
+      }
+      Position = (UINTN) (Requests[Last].Lba - Requests[First].Lba) * FtwLiteDevice->SizeOfSpareBlock +
+                 Requests[Last].Offset;
+      if ((Position + Requests[Last].NumBytes) > FtwLiteDevice->SpareAreaLength) {
+        break;
+      }
+      if (Position < Start) {
+        Start = Position;
+      }
+      if ((Position + Requests[Last].NumBytes) > End) {
+        End = Position + Requests[Last].NumBytes;
+      }
+    }
+
+    Status = FtwLiteAllocateRecord (FtwLiteDevice, Fvb, Requests[First].Lba, Start, End - Start);
+    if (EFI_ERROR (Status)) {
+      goto Done;
+    }
+
+    Status = FtwLiteReadSpareArea (FtwLiteDevice, Fvb, Requests[First].Lba, MyBuffer);
+    if (EFI_ERROR (Status)) {
+      goto Done;
+    }
+    //
+    // Overlay the requests in order, so later requests win where they overlap
+    //
+    for (Index = First; Index < Last; Index++) {
+      Position = (UINTN) (Requests[Index].Lba - Requests[First].Lba) * FtwLiteDevice->SizeOfSpareBlock +
+                 Requests[Index].Offset;
+      EfiCopyMem (MyBuffer + Position, Requests[Index].Buffer, Requests[Index].NumBytes);
+    }
+
+    Status = FtwLiteCommitSpareArea (FtwLiteDevice, Fvb, MyBuffer);
+    if (EFI_ERROR (Status)) {
+      goto Done;
+    }
+
+    DEBUG (
+      (EFI_D_FTW_INFO,
+      "FtwLite: WriteBatch() %d request(s) in one cycle at Lba %lx\n",
+      Last - First,
+      Requests[First].Lba)
+      );
+  }
+
+  //
+  // Restore spare backup buffer into spare block , if no failure happened during the batch.
+  // On failure the spare block may hold data that recovery still needs.
+  //
+  Status = FtwLiteWriteSpareArea (FtwLiteDevice, SpareBuffer);
+
+Done:
+  if (MyBuffer != NULL) {
+    gBS->FreePool (MyBuffer);
+  }
+  if (SpareBuffer != NULL) {
+    gBS->FreePool (SpareBuffer);
+  }
+
+  return Status;
+}
+
 STATIC
 EFI_STATUS
 FtwWriteRecord (
@@ -900,16 +1201,19 @@ InitializeFtwLite (
   //
   // Hook the protocol API
   //
-  FtwLiteDevice->FtwLiteInstance.Write = FtwLiteWrite;
+  FtwLiteDevice->FtwLiteInstance.Write           = FtwLiteWrite;
+  FtwLiteDevice->FtwLiteBatchInstance.WriteBatch = FtwLiteWriteBatch;
 
   //
   // Install protocol interface
   //
-  Status = gBS->InstallProtocolInterface (
+  Status = gBS->InstallMultipleProtocolInterfaces (
                   &FtwLiteDevice->Handle,
                   &gEfiFaultTolerantWriteLiteProtocolGuid,
-                  EFI_NATIVE_INTERFACE,
-                  &FtwLiteDevice->FtwLiteInstance
+                  &FtwLiteDevice->FtwLiteInstance,
+                  &gEfiFaultTolerantWriteLiteBatchProtocolGuid,
+                  &FtwLiteDevice->FtwLiteBatchInstance,
+                  NULL
                   );
   if (EFI_ERROR (Status)) {
     return EFI_ABORTED;
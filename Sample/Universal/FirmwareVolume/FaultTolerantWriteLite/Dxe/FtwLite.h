@@ -37,6 +37,7 @@ Abstract:
 #include EFI_PROTOCOL_CONSUMER (FirmwareVolumeBlock)
 #include EFI_PROTOCOL_CONSUMER (PciRootBridgeIo)
 #include EFI_PROTOCOL_PRODUCER (FaultTolerantWriteLite)
+#include EFI_PROTOCOL_PRODUCER (FaultTolerantWriteLiteBatch)
 
 #define EFI_D_FTW_LITE  EFI_D_ERROR
 #define EFI_D_FTW_INFO  EFI_D_INFO
@@ -112,6 +113,7 @@ typedef struct {
   UINTN                                   Signature;
   EFI_HANDLE                              Handle;
   EFI_FTW_LITE_PROTOCOL                   FtwLiteInstance;
+  EFI_FTW_LITE_BATCH_PROTOCOL             FtwLiteBatchInstance;
   EFI_PHYSICAL_ADDRESS                    WorkSpaceAddress;
   UINTN                                   WorkSpaceLength;
   EFI_PHYSICAL_ADDRESS                    SpareAreaAddress;
@@ -135,6 +137,8 @@ typedef struct {
 } EFI_FTW_LITE_DEVICE;
 
 #define FTW_LITE_CONTEXT_FROM_THIS(a) CR (a, EFI_FTW_LITE_DEVICE, FtwLiteInstance, FTW_LITE_DEVICE_SIGNATURE)
+#define FTW_LITE_CONTEXT_FROM_BATCH_THIS(a) \
+  CR (a, EFI_FTW_LITE_DEVICE, FtwLiteBatchInstance, FTW_LITE_DEVICE_SIGNATURE)
 
 //
 // Driver entry point
@@ -204,6 +208,37 @@ Returns:
 --*/
 ;
 
+EFI_STATUS
+EFIAPI
+FtwLiteWriteBatch (
+  IN EFI_FTW_LITE_BATCH_PROTOCOL           *This,
+  IN UINTN                                 RequestCount,
+  IN EFI_FTW_LITE_WRITE_REQUEST            *Requests
+  )
+/*++
+
+Routine Description:
+    Perform a list of fault tolerant writes. Consecutive requests that fall
+    within one spare area window of the same FVB share a single work space
+    record and spare block cycle.
+
+Arguments:
+    This             - Calling context
+    RequestCount     - Number of entries in Requests
+    Requests         - The writes to perform, in order
+
+Returns:
+    EFI_SUCCESS          - All writes completed successfully
+    EFI_INVALID_PARAMETER - Requests is NULL while RequestCount is not zero
+    EFI_BAD_BUFFER_SIZE  - A request would span the spare area
+    EFI_ACCESS_DENIED    - The last write has not been completed.
+    EFI_NOT_FOUND        - Cannot find FVB by handle.
+    EFI_OUT_OF_RESOURCES - Cannot allocate memory.
+    EFI_ABORTED          - The function could not complete successfully.
+
+--*/
+;
+
 //
 // Internal functions
 //
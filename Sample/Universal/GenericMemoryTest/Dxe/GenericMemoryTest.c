@@ -0,0 +1,854 @@
+/*++
+
+Copyright (c) 2004, Intel Corporation
+All rights reserved. This program and the accompanying materials
+are licensed and made available under the terms and conditions of the BSD License
+which accompanies this distribution.  The full text of the license may be found at
+http://opensource.org/licenses/bsd-license.php
+
+THE PROGRAM IS DISTRIBUTED UNDER THE BSD LICENSE ON AN "AS IS" BASIS,
+WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
+
+Module Name:
+
+  GenericMemoryTest.c
+
+Abstract:
+
+  Generic memory test driver. Untested memory reported by GCD is tested in
+  TEST_BLOCK_SIZE blocks and each block is handed to GCD as tested system
+  memory as soon as it passes. The coverage level selects how much of each
+  block is touched and how many patterns are applied:
+
+    QUICK     - A MONO_TEST_SIZE window every QUICK_SPAN_SIZE, address pattern.
+    SPARSE    - A MONO_TEST_SIZE window every SPARSE_SPAN_SIZE, address and
+                checkerboard patterns.
+    EXTENSIVE - Every byte, address, checkerboard and inverse checkerboard
+                patterns.
+
+--*/
+
+#include "GenericMemoryTest.h"
+
+//
+// Patterns are applied in this order, a level uses the first PatternCount.
+//
+UINT64                            mTestPattern[MAX_TEST_PATTERN] = {
+  TEST_PATTERN_ADDRESS,
+  0x5A5A5A5AA5A5A5A5,
+  0xA5A5A5A55A5A5A5A
+};
+
+GENERIC_MEMORY_TEST_PRIVATE       mGenericMemoryTestPrivate = {
+  EFI_GENERIC_MEMORY_TEST_PRIVATE_SIGNATURE,
+  NULL,
+  {
+    InitializeMemoryTest,
+    GenPerformMemoryTest,
+    GenMemoryTestFinished,
+    GenCompatibleRangeTest
+  }
+};
+
+EFI_DRIVER_ENTRY_POINT (GenericMemoryTestEntryPoint)
+
+EFI_STATUS
+EFIAPI
+GenericMemoryTestEntryPoint (
+  IN  EFI_HANDLE           ImageHandle,
+  IN  EFI_SYSTEM_TABLE     *SystemTable
+  )
+/*++
+
+Routine Description:
+
+  The generic memory test driver's entry point, it can initialize private data
+  to default value
+
+Arguments:
+
+  ImageHandle of the loaded driver
+  Pointer to the System Table
+
+Returns:
+
+  Status
+
+  EFI_SUCCESS           - Protocol successfully installed
+  EFI_OUT_OF_RESOURCES  - Can not allocate protocol data structure in base
+                          memory
+
+--*/
+{
+  EFI_STATUS  Status;
+
+  DxeInitializeDriverLib (ImageHandle, SystemTable);
+
+  InitializeListHead (&mGenericMemoryTestPrivate.NonTestedMemRanList);
+
+  //
+  // Install the protocol
+  //
+  Status = gBS->InstallProtocolInterface (
+                  &mGenericMemoryTestPrivate.Handle,
+                  &gEfiGenericMemTestProtocolGuid,
+                  EFI_NATIVE_INTERFACE,
+                  &mGenericMemoryTestPrivate.GenericMemoryTest
+                  );
+
+  return Status;
+}
+
+STATIC
+VOID
+MemoryTestFill (
+  IN EFI_PHYSICAL_ADDRESS                      Start,
+  IN UINTN                                     Length,
+  IN UINT64                                    Pattern
+  )
+/*++
+
+Routine Description:
+
+  Fill a range with a pattern, a cache line at a time.
+
+Arguments:
+
+  Start   - Start of the range, cache line aligned.
+  Length  - Length of the range, a multiple of GENERIC_CACHELINE_SIZE.
+  Pattern - The pattern, or TEST_PATTERN_ADDRESS.
+
+Returns:
+
+  None
+
+--*/
+{
+  volatile UINT64 *Pointer;
+  volatile UINT64 *End;
+
+  Pointer = (UINT64 *) (UINTN) Start;
+  End     = (UINT64 *) (UINTN) (Start + Length);
+
+  if (Pattern == TEST_PATTERN_ADDRESS) {
+    for (; Pointer < End; Pointer += GENERIC_CACHELINE_SIZE / sizeof (UINT64)) {
+      Pointer[0]  = (UINT64) (UINTN) &Pointer[0];
+      Pointer[1]  = (UINT64) (UINTN) &Pointer[1];
+      Pointer[2]  = (UINT64) (UINTN) &Pointer[2];
+      Pointer[3]  = (UINT64) (UINTN) &Pointer[3];
+      Pointer[4]  = (UINT64) (UINTN) &Pointer[4];
+      Pointer[5]  = (UINT64) (UINTN) &Pointer[5];
+      Pointer[6]  = (UINT64) (UINTN) &Pointer[6];
+      Pointer[7]  = (UINT64) (UINTN) &Pointer[7];
+    }
+  } else {
+    for (; Pointer < End; Pointer += GENERIC_CACHELINE_SIZE / sizeof (UINT64)) {
+      Pointer[0]  = Pattern;
+      Pointer[1]  = Pattern;
+      Pointer[2]  = Pattern;
+      Pointer[3]  = Pattern;
+      Pointer[4]  = Pattern;
+      Pointer[5]  = Pattern;
+      Pointer[6]  = Pattern;
+      Pointer[7]  = Pattern;
+    }
+  }
+}
+
+STATIC
+BOOLEAN
+MemoryTestVerify (
+  IN  EFI_PHYSICAL_ADDRESS                     Start,
+  IN  UINTN                                    Length,
+  IN  UINT64                                   Pattern,
+  OUT EFI_PHYSICAL_ADDRESS                     *ErrorAddress
+  )
+/*++
+
+Routine Description:
+
+  Check a range filled by MemoryTestFill (). Differences are accumulated
+  over a whole cache line so the common case costs one branch per line.
+
+Arguments:
+
+  Start         - Start of the range, cache line aligned.
+  Length        - Length of the range, a multiple of GENERIC_CACHELINE_SIZE.
+  Pattern       - The pattern, or TEST_PATTERN_ADDRESS.
+  ErrorAddress  - Address of the first UINT64 that does not match.
+
+Returns:
+
+  TRUE  - The range matches the pattern.
+  FALSE - The range does not match, ErrorAddress is returned.
+
+--*/
+{
+  volatile UINT64 *Pointer;
+  volatile UINT64 *End;
+  UINT64          Expected;
+  UINT64          Diff;
+  UINTN           Index;
+
+  Pointer = (UINT64 *) (UINTN) Start;
+  End     = (UINT64 *) (UINTN) (Start + Length);
+
+  for (; Pointer < End; Pointer += GENERIC_CACHELINE_SIZE / sizeof (UINT64)) {
+    if (Pattern == TEST_PATTERN_ADDRESS) {
+      Diff = (Pointer[0] ^ (UINT64) (UINTN) &Pointer[0]) |
+             (Pointer[1] ^ (UINT64) (UINTN) &Pointer[1]) |
+             (Pointer[2] ^ (UINT64) (UINTN) &Pointer[2]) |
+             (Pointer[3] ^ (UINT64) (UINTN) &Pointer[3]) |
+             (Pointer[4] ^ (UINT64) (UINTN) &Pointer[4]) |
+             (Pointer[5] ^ (UINT64) (UINTN) &Pointer[5]) |
+             (Pointer[6] ^ (UINT64) (UINTN) &Pointer[6]) |
+             (Pointer[7] ^ (UINT64) (UINTN) &Pointer[7]);
+    } else {
+      Diff = (Pointer[0] ^ Pattern) | (Pointer[1] ^ Pattern) |
+             (Pointer[2] ^ Pattern) | (Pointer[3] ^ Pattern) |
+             (Pointer[4] ^ Pattern) | (Pointer[5] ^ Pattern) |
+             (Pointer[6] ^ Pattern) | (Pointer[7] ^ Pattern);
+    }
+
+    if (Diff != 0) {
+      for (Index = 0; Index < GENERIC_CACHELINE_SIZE / sizeof (UINT64); Index++) {
+        Expected = (Pattern == TEST_PATTERN_ADDRESS) ? (UINT64) (UINTN) &Pointer[Index] : Pattern;
+        if (Pointer[Index] != Expected) {
+          break;
+        }
+      }
+
+      *ErrorAddress = (EFI_PHYSICAL_ADDRESS) (UINTN) &Pointer[Index];
+      return FALSE;
+    }
+  }
+
+  return TRUE;
+}
+
+STATIC
+VOID
+LocateCpuArch (
+  IN GENERIC_MEMORY_TEST_PRIVATE               *Private
+  )
+/*++
+
+Routine Description:
+
+  Locate the CPU architectural protocol, used to flush the caches between
+  the write and verify passes and to time the test. The test still runs
+  without it.
+
+Arguments:
+
+  Private - Memory test private data.
+
+Returns:
+
+  None
+
+--*/
+{
+  EFI_STATUS  Status;
+  UINT64      TimerValue;
+
+  if (Private->Cpu == NULL) {
+    Status = gBS->LocateProtocol (&gEfiCpuArchProtocolGuid, NULL, (VOID **) &Private->Cpu);
+    if (EFI_ERROR (Status)) {
+      Private->Cpu = NULL;
+      return;
+    }
+
+    Status = Private->Cpu->GetTimerValue (Private->Cpu, 0, &TimerValue, &Private->TimerPeriod);
+    if (EFI_ERROR (Status)) {
+      Private->TimerPeriod = 0;
+    }
+  }
+}
+
+STATIC
+UINT64
+MemoryTestTimer (
+  IN GENERIC_MEMORY_TEST_PRIVATE               *Private
+  )
+{
+  UINT64  TimerValue;
+
+  if ((Private->TimerPeriod == 0) ||
+      EFI_ERROR (Private->Cpu->GetTimerValue (Private->Cpu, 0, &TimerValue, NULL))) {
+    return 0;
+  }
+
+  return TimerValue;
+}
+
+STATIC
+EFI_STATUS
+MemoryTestRange (
+  IN  GENERIC_MEMORY_TEST_PRIVATE              *Private,
+  IN  EFI_PHYSICAL_ADDRESS                     Start,
+  IN  UINT64                                   Length,
+  IN  UINTN                                    Span,
+  IN  UINTN                                    PatternCount,
+  OUT EFI_PHYSICAL_ADDRESS                     *ErrorAddress
+  )
+/*++
+
+Routine Description:
+
+  Test a MONO_TEST_SIZE window every Span bytes of a range. Each pattern is
+  written to all windows first and the caches are written back and
+  invalidated before the windows are verified, so the data is read back
+  from memory rather than from the cache.
+
+Arguments:
+
+  Private       - Memory test private data.
+  Start         - Start of the range, cache line aligned.
+  Length        - Length of the range.
+  Span          - Distance between windows, MONO_TEST_SIZE tests every byte.
+  PatternCount  - Number of entries of mTestPattern to apply.
+  ErrorAddress  - Address of the first failure.
+
+Returns:
+
+  EFI_SUCCESS       - The range passed.
+  EFI_UNSUPPORTED   - The range is not addressable by this driver and was
+                      not tested, the caller releases it untested.
+  EFI_DEVICE_ERROR  - The range failed, ErrorAddress is returned.
+
+--*/
+{
+  EFI_PHYSICAL_ADDRESS  End;
+  EFI_PHYSICAL_ADDRESS  Window;
+  UINTN                 WindowSize;
+  UINTN                 Index;
+  UINT64                StartTime;
+  UINT64                EndTime;
+
+  Length &= ~((UINT64) GENERIC_CACHELINE_SIZE - 1);
+  End     = Start + Length;
+
+  if (Length == 0) {
+    return EFI_SUCCESS;
+  }
+  //
+  // Memory the processor can not address in the current mode is not tested.
+  //
+  if (End - 1 > EFI_MAX_ADDRESS) {
+    return EFI_UNSUPPORTED;
+  }
+
+  StartTime = MemoryTestTimer (Private);
+
+  for (Index = 0; Index < PatternCount; Index++) {
+    for (Window = Start; Window < End; Window += Span) {
+      WindowSize = (End - Window < MONO_TEST_SIZE) ? (UINTN) (End - Window) : MONO_TEST_SIZE;
+      MemoryTestFill (Window, WindowSize, mTestPattern[Index]);
+      Private->BytesTouched += WindowSize;
+    }
+
+    if (Private->Cpu != NULL) {
+      Private->Cpu->FlushDataCache (Private->Cpu, Start, Length, EfiCpuFlushTypeWriteBackInvalidate);
+    }
+
+    for (Window = Start; Window < End; Window += Span) {
+      WindowSize = (End - Window < MONO_TEST_SIZE) ? (UINTN) (End - Window) : MONO_TEST_SIZE;
+      if (!MemoryTestVerify (Window, WindowSize, mTestPattern[Index], ErrorAddress)) {
+        return EFI_DEVICE_ERROR;
+      }
+
+      Private->BytesTouched += WindowSize;
+    }
+  }
+
+  EndTime = MemoryTestTimer (Private);
+  if (EndTime > StartTime) {
+    Private->ElapsedTicks += EndTime - StartTime;
+  }
+
+  return EFI_SUCCESS;
+}
+
+STATIC
+VOID
+ConvertToTestedMemory (
+  IN EFI_PHYSICAL_ADDRESS                      Start,
+  IN UINT64                                    Length,
+  IN UINT64                                    Capabilities
+  )
+{
+  gDS->RemoveMemorySpace (Start, Length);
+
+  gDS->AddMemorySpace (
+        EfiGcdMemoryTypeSystemMemory,
+        Start,
+        Length,
+        Capabilities &~(EFI_MEMORY_PRESENT | EFI_MEMORY_INITIALIZED | EFI_MEMORY_TESTED | EFI_MEMORY_RUNTIME)
+        );
+}
+
+STATIC
+VOID
+ReportMemoryTestError (
+  IN EFI_PHYSICAL_ADDRESS                      ErrorAddress
+  )
+{
+  EFI_MEMORY_RANGE_EXTENDED_DATA  RangeData;
+
+  RangeData.DataHeader.HeaderSize = sizeof (EFI_STATUS_CODE_DATA);
+  RangeData.DataHeader.Size       = sizeof (EFI_MEMORY_RANGE_EXTENDED_DATA) - sizeof (EFI_STATUS_CODE_DATA);
+  EfiCopyMem (&RangeData.DataHeader.Type, &gEfiStatusCodeSpecificDataGuid, sizeof (EFI_GUID));
+  RangeData.Start   = ErrorAddress;
+  RangeData.Length  = sizeof (UINT64);
+
+  EfiLibReportStatusCode (
+    EFI_ERROR_CODE | EFI_ERROR_UNRECOVERED,
+    EFI_COMPUTING_UNIT_MEMORY | EFI_CU_MEMORY_EC_UNCORRECTABLE,
+    0,
+    &gEfiCallerIdGuid,
+    &RangeData.DataHeader
+    );
+}
+
+STATIC
+VOID
+ReportMemoryTestThroughput (
+  IN GENERIC_MEMORY_TEST_PRIVATE               *Private
+  )
+/*++
+
+Routine Description:
+
+  Report the amount of memory touched by the test and the rate it was
+  touched at as an ASCII string progress code.
+
+Arguments:
+
+  Private - Memory test private data.
+
+Returns:
+
+  None
+
+--*/
+{
+  EFI_STATUS_CODE_STRING_DATA StringData;
+  CHAR8                       String[80];
+  UINTN                       TicksPerMs;
+  UINT64                      ElapsedMs;
+  UINTN                       MegaBytes;
+  UINTN                       MegaBytesPerSecond;
+
+  if ((Private->TimerPeriod == 0) || (Private->BytesTouched == 0)) {
+    return;
+  }
+
+  //
+  // TimerPeriod is in femtoseconds, 10^12 of them make a millisecond.
+  //
+  TicksPerMs  = (UINTN) DivU64x32 (1000000000000, (UINTN) Private->TimerPeriod, NULL);
+  ElapsedMs   = (TicksPerMs == 0) ? 0 : DivU64x32 (Private->ElapsedTicks, TicksPerMs, NULL);
+  if (ElapsedMs == 0) {
+    return;
+  }
+
+  MegaBytes           = (UINTN) RShiftU64 (Private->BytesTouched, 20);
+  MegaBytesPerSecond  = (UINTN) DivU64x32 (MultU64x32 (MegaBytes, 1000), (UINTN) ElapsedMs, NULL);
+
+  ASPrint (
+    String,
+    sizeof (String),
+    "Memory test: %d MB in %d ms, %d.%02d GB/s",
+    MegaBytes,
+    (UINTN) ElapsedMs,
+    MegaBytesPerSecond / 1024,
+    (MegaBytesPerSecond % 1024) * 100 / 1024
+    );
+
+  StringData.DataHeader.HeaderSize  = sizeof (EFI_STATUS_CODE_DATA);
+  StringData.DataHeader.Size        = sizeof (EFI_STATUS_CODE_STRING_DATA) - sizeof (EFI_STATUS_CODE_DATA);
+  EfiCopyMem (&StringData.DataHeader.Type, &gEfiStatusCodeDataTypeStringGuid, sizeof (EFI_GUID));
+  StringData.StringType   = EfiStringAscii;
+  StringData.String.Ascii = String;
+
+  EfiLibReportStatusCode (
+    EFI_PROGRESS_CODE,
+    EFI_COMPUTING_UNIT_MEMORY | EFI_CU_MEMORY_PC_TEST,
+    0,
+    &gEfiCallerIdGuid,
+    &StringData.DataHeader
+    );
+}
+
+STATIC
+VOID
+ReleaseNonTestedMemory (
+  IN GENERIC_MEMORY_TEST_PRIVATE               *Private
+  )
+/*++
+
+Routine Description:
+
+  Hand every range that is still untested to GCD as system memory and
+  empty the untested range list.
+
+Arguments:
+
+  Private - Memory test private data.
+
+Returns:
+
+  None
+
+--*/
+{
+  NONTESTED_MEMORY_RANGE  *Range;
+
+  while (!IsListEmpty (&Private->NonTestedMemRanList)) {
+    Range = NONTESTED_MEMORY_RANGE_FROM_LINK (Private->NonTestedMemRanList.ForwardLink);
+    ConvertToTestedMemory (
+      Private->CurrentAddress,
+      Range->StartAddress + Range->Length - Private->CurrentAddress,
+      Range->Capabilities
+      );
+
+    RemoveEntryList (&Range->Link);
+    gBS->FreePool (Range);
+
+    if (!IsListEmpty (&Private->NonTestedMemRanList)) {
+      Range = NONTESTED_MEMORY_RANGE_FROM_LINK (Private->NonTestedMemRanList.ForwardLink);
+      Private->CurrentAddress = Range->StartAddress;
+    }
+  }
+
+  Private->TestedMemorySize = Private->TotalMemorySize;
+}
+
+//
+// EFI_GENERIC_MEMORY_TEST_PROTOCOL implementation
+//
+EFI_STATUS
+EFIAPI
+InitializeMemoryTest (
+  IN EFI_GENERIC_MEMORY_TEST_PROTOCOL          *This,
+  IN  EXTENDMEM_COVERAGE_LEVEL                 Level,
+  OUT BOOLEAN                                  *RequireSoftECCInit
+  )
+/*++
+
+Routine Description:
+
+  Collect the untested memory ranges from GCD and select the coverage of
+  the test.
+
+Arguments:
+
+  This                - Protocol instance pointer.
+  Level               - The coverage level of the memory test.
+  RequireSoftECCInit  - Always FALSE, the patterns initialize the ECC.
+
+Returns:
+
+  EFI_SUCCESS           - There is untested memory to test.
+  EFI_NO_MEDIA          - There is no untested memory.
+  EFI_OUT_OF_RESOURCES  - The untested range list could not be built.
+
+--*/
+{
+  EFI_STATUS                      Status;
+  GENERIC_MEMORY_TEST_PRIVATE     *Private;
+  UINTN                           NumberOfDescriptors;
+  EFI_GCD_MEMORY_SPACE_DESCRIPTOR *MemorySpaceMap;
+  NONTESTED_MEMORY_RANGE          *Range;
+  UINTN                           Index;
+
+  Private = GENERIC_MEMORY_TEST_PRIVATE_FROM_THIS (This);
+
+  *RequireSoftECCInit = FALSE;
+
+  Private->CoverLevel = Level;
+  switch (Level) {
+  case QUICK:
+    Private->CoverageSpan = QUICK_SPAN_SIZE;
+    Private->PatternCount = 1;
+    break;
+
+  case SPARSE:
+    Private->CoverageSpan = SPARSE_SPAN_SIZE;
+    Private->PatternCount = 2;
+    break;
+
+  case EXTENSIVE:
+    Private->CoverageSpan = MONO_TEST_SIZE;
+    Private->PatternCount = MAX_TEST_PATTERN;
+    break;
+
+  default:
+    Private->CoverageSpan = 0;
+    Private->PatternCount = 0;
+    break;
+  }
+
+  LocateCpuArch (Private);
+
+  Private->BaseMemorySize   = 0;
+  Private->TotalMemorySize  = 0;
+  Private->BytesTouched     = 0;
+  Private->ElapsedTicks     = 0;
+
+  Status = gDS->GetMemorySpaceMap (&NumberOfDescriptors, &MemorySpaceMap);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  for (Index = 0; Index < NumberOfDescriptors; Index++) {
+    if (MemorySpaceMap[Index].GcdMemoryType == EfiGcdMemoryTypeReserved &&
+        (MemorySpaceMap[Index].Capabilities & (EFI_MEMORY_PRESENT | EFI_MEMORY_INITIALIZED | EFI_MEMORY_TESTED)) ==
+          (EFI_MEMORY_PRESENT | EFI_MEMORY_INITIALIZED)
+          ) {
+      Range = EfiLibAllocateZeroPool (sizeof (NONTESTED_MEMORY_RANGE));
+      if (Range == NULL) {
+        gBS->FreePool (MemorySpaceMap);
+        return EFI_OUT_OF_RESOURCES;
+      }
+
+      Range->Signature    = EFI_NONTESTED_MEMORY_RANGE_SIGNATURE;
+      Range->StartAddress = MemorySpaceMap[Index].BaseAddress;
+      Range->Length       = MemorySpaceMap[Index].Length;
+      Range->Capabilities = MemorySpaceMap[Index].Capabilities;
+      Range->Above4G      = (BOOLEAN) (Range->StartAddress + Range->Length > 0x100000000);
+      InsertTailList (&Private->NonTestedMemRanList, &Range->Link);
+
+      Private->TotalMemorySize += MemorySpaceMap[Index].Length;
+    } else if (MemorySpaceMap[Index].GcdMemoryType == EfiGcdMemoryTypeSystemMemory) {
+      Private->BaseMemorySize += MemorySpaceMap[Index].Length;
+    }
+  }
+
+  gBS->FreePool (MemorySpaceMap);
+
+  Private->TotalMemorySize += Private->BaseMemorySize;
+  Private->TestedMemorySize = Private->BaseMemorySize;
+
+  if (IsListEmpty (&Private->NonTestedMemRanList)) {
+    return EFI_NO_MEDIA;
+  }
+
+  Range = NONTESTED_MEMORY_RANGE_FROM_LINK (Private->NonTestedMemRanList.ForwardLink);
+  Private->CurrentAddress = Range->StartAddress;
+
+  EfiLibReportStatusCode (
+    EFI_PROGRESS_CODE,
+    EFI_COMPUTING_UNIT_MEMORY | EFI_CU_MEMORY_PC_TEST,
+    0,
+    &gEfiCallerIdGuid,
+    NULL
+    );
+
+  return EFI_SUCCESS;
+}
+
+EFI_STATUS
+EFIAPI
+GenPerformMemoryTest (
+  IN EFI_GENERIC_MEMORY_TEST_PROTOCOL          *This,
+  IN OUT UINT64                                *TestedMemorySize,
+  OUT UINT64                                   *TotalMemorySize,
+  OUT BOOLEAN                                  *ErrorOut,
+  IN BOOLEAN                                   TestAbort
+  )
+/*++
+
+Routine Description:
+
+  Test the next TEST_BLOCK_SIZE block of untested memory. A block that
+  passes is added to GCD as tested system memory, a block that fails or
+  can not be addressed is left reserved.
+
+Arguments:
+
+  This              - Protocol instance pointer.
+  TestedMemorySize  - Return the tested memory size.
+  TotalMemorySize   - Return the whole system memory size.
+  ErrorOut          - TRUE if the block failed.
+  TestAbort         - Release the remaining memory without testing it.
+
+Returns:
+
+  EFI_SUCCESS       - One block was tested.
+  EFI_DEVICE_ERROR  - One block was tested and failed.
+  EFI_NOT_FOUND     - All the untested memory has been processed.
+
+--*/
+{
+  EFI_STATUS                  Status;
+  GENERIC_MEMORY_TEST_PRIVATE *Private;
+  NONTESTED_MEMORY_RANGE      *Range;
+  UINT64                      BlockLength;
+  EFI_PHYSICAL_ADDRESS        ErrorAddress;
+
+  Private   = GENERIC_MEMORY_TEST_PRIVATE_FROM_THIS (This);
+  *ErrorOut = FALSE;
+  Status    = EFI_NOT_FOUND;
+
+  if (!IsListEmpty (&Private->NonTestedMemRanList)) {
+    if (TestAbort || (Private->PatternCount == 0)) {
+      ReleaseNonTestedMemory (Private);
+    } else {
+      Range       = NONTESTED_MEMORY_RANGE_FROM_LINK (Private->NonTestedMemRanList.ForwardLink);
+      BlockLength = Range->StartAddress + Range->Length - Private->CurrentAddress;
+      if (BlockLength > TEST_BLOCK_SIZE) {
+        BlockLength = TEST_BLOCK_SIZE;
+      }
+
+      Status = MemoryTestRange (
+                Private,
+                Private->CurrentAddress,
+                BlockLength,
+                Private->CoverageSpan,
+                Private->PatternCount,
+                &ErrorAddress
+                );
+      //
+      // Memory that can't be addressed is released untested, like
+      // ReleaseNonTestedMemory does, so the OS still gets it.
+      //
+      if (Status == EFI_UNSUPPORTED) {
+        Status = EFI_SUCCESS;
+      }
+
+      if (EFI_ERROR (Status)) {
+        ReportMemoryTestError (ErrorAddress);
+        *ErrorOut = TRUE;
+      } else {
+        ConvertToTestedMemory (Private->CurrentAddress, BlockLength, Range->Capabilities);
+      }
+
+      Private->TestedMemorySize += BlockLength;
+      Private->CurrentAddress   += BlockLength;
+
+      if (Private->CurrentAddress == Range->StartAddress + Range->Length) {
+        RemoveEntryList (&Range->Link);
+        gBS->FreePool (Range);
+
+        if (IsListEmpty (&Private->NonTestedMemRanList)) {
+          ReportMemoryTestThroughput (Private);
+        } else {
+          Range = NONTESTED_MEMORY_RANGE_FROM_LINK (Private->NonTestedMemRanList.ForwardLink);
+          Private->CurrentAddress = Range->StartAddress;
+        }
+      }
+    }
+  }
+
+  *TestedMemorySize = Private->TestedMemorySize;
+  *TotalMemorySize  = Private->TotalMemorySize;
+
+  return Status;
+}
+
+EFI_STATUS
+EFIAPI
+GenMemoryTestFinished (
+  IN EFI_GENERIC_MEMORY_TEST_PROTOCOL *This
+  )
+/*++
+
+Routine Description:
+
+  The memory test finished. Any memory left untested, because the test was
+  skipped, is released to GCD.
+
+Arguments:
+
+  This  - Protocol instance pointer.
+
+Returns:
+
+  EFI_SUCCESS - The untested range list was released.
+
+--*/
+{
+  ReleaseNonTestedMemory (GENERIC_MEMORY_TEST_PRIVATE_FROM_THIS (This));
+  return EFI_SUCCESS;
+}
+
+EFI_STATUS
+EFIAPI
+GenCompatibleRangeTest (
+  IN EFI_GENERIC_MEMORY_TEST_PROTOCOL          *This,
+  IN  EFI_PHYSICAL_ADDRESS                     StartAddress,
+  IN  UINT64                                   Length
+  )
+/*++
+
+Routine Description:
+
+  Test a range extensively and add it to GCD as tested system memory. This
+  must be called before InitializeMemoryTest () collects untested ranges.
+  The range may span several GCD descriptors; only the parts that are
+  present, initialized and untested reserved memory are tested and
+  converted, each with the capabilities of its own descriptor.
+
+Arguments:
+
+  This          - Protocol instance pointer.
+  StartAddress  - The start address of the memory range.
+  Length        - The memory range's length.
+
+Returns:
+
+  EFI_SUCCESS       - The range passed the test or is already tested.
+  EFI_DEVICE_ERROR  - The range failed the test.
+
+--*/
+{
+  EFI_STATUS                      Status;
+  GENERIC_MEMORY_TEST_PRIVATE     *Private;
+  EFI_GCD_MEMORY_SPACE_DESCRIPTOR Descriptor;
+  EFI_PHYSICAL_ADDRESS            ErrorAddress;
+  EFI_PHYSICAL_ADDRESS            Address;
+  EFI_PHYSICAL_ADDRESS            End;
+  EFI_PHYSICAL_ADDRESS            PartEnd;
+
+  Private = GENERIC_MEMORY_TEST_PRIVATE_FROM_THIS (This);
+  LocateCpuArch (Private);
+
+  End = StartAddress + Length;
+  for (Address = StartAddress; Address < End; Address = PartEnd) {
+    Status = gDS->GetMemorySpaceDescriptor (Address, &Descriptor);
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+
+    PartEnd = Descriptor.BaseAddress + Descriptor.Length;
+    if (PartEnd > End) {
+      PartEnd = End;
+    }
+
+    if (Descriptor.GcdMemoryType != EfiGcdMemoryTypeReserved ||
+        (Descriptor.Capabilities & (EFI_MEMORY_PRESENT | EFI_MEMORY_INITIALIZED | EFI_MEMORY_TESTED)) !=
+          (EFI_MEMORY_PRESENT | EFI_MEMORY_INITIALIZED)
+          ) {
+      continue;
+    }
+
+    Status = MemoryTestRange (
+              Private,
+              Address,
+              PartEnd - Address,
+              MONO_TEST_SIZE,
+              MAX_TEST_PATTERN,
+              &ErrorAddress
+              );
+    if (EFI_ERROR (Status) && (Status != EFI_UNSUPPORTED)) {
+      ReportMemoryTestError (ErrorAddress);
+      return EFI_DEVICE_ERROR;
+    }
+
+    ConvertToTestedMemory (Address, PartEnd - Address, Descriptor.Capabilities);
+  }
+
+  return EFI_SUCCESS;
+}
@@ -0,0 +1,118 @@
+/*++
+
+Copyright (c) 2004, Intel Corporation
+All rights reserved. This program and the accompanying materials
+are licensed and made available under the terms and conditions of the BSD License
+which accompanies this distribution.  The full text of the license may be found at
+http://opensource.org/licenses/bsd-license.php
+
+THE PROGRAM IS DISTRIBUTED UNDER THE BSD LICENSE ON AN "AS IS" BASIS,
+WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
+
+Module Name:
+
+    GenericMemoryTest.h
+
+Abstract:
+  The generic memory test driver definition
+
+--*/
+
+#ifndef _GENERIC_MEMORY_TEST_H
+#define _GENERIC_MEMORY_TEST_H
+
+#include "Common.h"
+
+//
+// Size of the window tested at the start of every span in QUICK and SPARSE
+// mode. Must not be larger than SPARSE_SPAN_SIZE.
+//
+#define MONO_TEST_SIZE          0x1000
+
+//
+// Maximum number of patterns applied to a block, see mTestPattern.
+//
+#define MAX_TEST_PATTERN        3
+
+//
+// A pattern of TEST_PATTERN_ADDRESS makes every UINT64 hold its own address,
+// which catches address line faults and aliasing.
+//
+#define TEST_PATTERN_ADDRESS    0
+
+typedef struct {
+  UINTN                             Signature;
+  EFI_HANDLE                        Handle;
+  EFI_GENERIC_MEMORY_TEST_PROTOCOL  GenericMemoryTest;
+
+  //
+  // Optional, used to push patterns out to memory and to time the test.
+  //
+  EFI_CPU_ARCH_PROTOCOL             *Cpu;
+
+  EXTENDMEM_COVERAGE_LEVEL          CoverLevel;
+  UINTN                             CoverageSpan;
+  UINTN                             PatternCount;
+
+  //
+  // Untested ranges, and the next address to test in the first range.
+  //
+  EFI_LIST_ENTRY                    NonTestedMemRanList;
+  EFI_PHYSICAL_ADDRESS              CurrentAddress;
+
+  UINT64                            BaseMemorySize;
+  UINT64                            TestedMemorySize;
+  UINT64                            TotalMemorySize;
+
+  //
+  // Bytes actually written and verified, and the time spent doing it.
+  // TimerPeriod is in femtoseconds, zero if the CPU timer is not usable.
+  //
+  UINT64                            BytesTouched;
+  UINT64                            ElapsedTicks;
+  UINT64                            TimerPeriod;
+} GENERIC_MEMORY_TEST_PRIVATE;
+
+#define GENERIC_MEMORY_TEST_PRIVATE_FROM_THIS(a) \
+  CR (a, GENERIC_MEMORY_TEST_PRIVATE, GenericMemoryTest, EFI_GENERIC_MEMORY_TEST_PRIVATE_SIGNATURE)
+
+//
+// Function Prototypes
+//
+EFI_STATUS
+EFIAPI
+InitializeMemoryTest (
+  IN EFI_GENERIC_MEMORY_TEST_PROTOCOL          *This,
+  IN  EXTENDMEM_COVERAGE_LEVEL                 Level,
+  OUT BOOLEAN                                  *RequireSoftECCInit
+  )
+;
+
+EFI_STATUS
+EFIAPI
+GenPerformMemoryTest (
+  IN EFI_GENERIC_MEMORY_TEST_PROTOCOL          *This,
+  IN OUT UINT64                                *TestedMemorySize,
+  OUT UINT64                                   *TotalMemorySize,
+  OUT BOOLEAN                                  *ErrorOut,
+  IN BOOLEAN                                   TestAbort
+  )
+;
+
+EFI_STATUS
+EFIAPI
+GenMemoryTestFinished (
+  IN EFI_GENERIC_MEMORY_TEST_PROTOCOL *This
+  )
+;
+
+EFI_STATUS
+EFIAPI
+GenCompatibleRangeTest (
+  IN EFI_GENERIC_MEMORY_TEST_PROTOCOL          *This,
+  IN  EFI_PHYSICAL_ADDRESS                     StartAddress,
+  IN  UINT64                                   Length
+  )
+;
+
+#endif
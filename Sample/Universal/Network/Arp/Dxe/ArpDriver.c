@@ -476,6 +476,7 @@ Returns:
     ArpCleanService (ArpService);
 
     NetFreePool (ArpService);
+    NetbufCacheFlush ();
   } else {
 
     while (!NetListIsEmpty (&ArpService->ChildrenList)) {
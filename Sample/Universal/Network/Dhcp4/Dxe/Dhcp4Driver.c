@@ -434,6 +434,7 @@ Dhcp4DriverBindingStop (
     Dhcp4CloseService (DhcpSb);
 
     NetFreePool (DhcpSb);
+    NetbufCacheFlush ();
   } else {
     //
     // Don't use NET_LIST_FOR_EACH_SAFE here, Dhcp4ServiceBindingDestoryChild
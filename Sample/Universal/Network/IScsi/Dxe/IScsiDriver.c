@@ -311,6 +311,7 @@ Returns:
 
   IScsiSessionAbort (&Private->Session);
   IScsiCleanDriverData (Private);
+  NetbufCacheFlush ();
 
   return EFI_SUCCESS;
 }
@@ -365,6 +366,9 @@ Returns:
       NetFreePool (DeviceHandleBuffer);
     }
   }
+
+  NetbufCacheFlush ();
+
   //
   // Unload the iSCSI configuration form.
   //
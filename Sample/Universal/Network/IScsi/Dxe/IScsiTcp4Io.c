@@ -130,7 +130,7 @@ Returns:
   ControlOption.EnableNagle             = FALSE;
   ControlOption.EnableTimeStamp         = FALSE;
   ControlOption.EnableWindowScaling     = TRUE;
-  ControlOption.EnableSelectiveAck      = FALSE;
+  ControlOption.EnableSelectiveAck      = TRUE;
   ControlOption.EnablePathMtuDiscovery  = FALSE;
 
   Tcp4ConfigData.TypeOfService          = 8;
@@ -694,6 +694,7 @@ Ip4DriverBindingStop (
            );
 
     NetFreePool (IpSb);
+    NetbufCacheFlush ();
   } else if (NumberOfChildren == 0) {
     IpSb->InDestory = TRUE;
 
@@ -722,6 +723,7 @@ Ip4DriverBindingStop (
            );
 
     NetFreePool (IpSb);
+    NetbufCacheFlush ();
   } else {
 
     while (!NetListIsEmpty (&IpSb->Children)) {
@@ -243,6 +243,7 @@ Returns:
   NET_BUF                   *Data;
   EFI_STATUS                Status;
   IP4_HEAD                  ReplyHead;
+  UINT16                    OldWord;
 
   //
   // make a copy the packet, it is really a bad idea to 
@@ -261,10 +262,13 @@ Returns:
   // use specific destination. See RFC1122. SRR/RR option
   // update is omitted.
   //
+  // The request's checksum has been verified, so patch it for the type
+  // change instead of summing the echo data again.
+  //
   Icmp                = (IP4_ICMP_QUERY_HEAD *) NetbufGetByte (Data, 0, NULL);
+  OldWord             = *(UINT16 *) Icmp;
   Icmp->Head.Type     = ICMP_ECHO_REPLY;
-  Icmp->Head.Checksum = 0;
-  Icmp->Head.Checksum = ~NetblockChecksum ((UINT8 *) Icmp, Data->TotalSize);
+  Icmp->Head.Checksum = NetUpdateChecksum (Icmp->Head.Checksum, OldWord, *(UINT16 *) Icmp);
 
   ReplyHead.Tos       = 0;
   ReplyHead.Fragment  = 0;
@@ -218,7 +218,7 @@ Returns:
   }
 
   if (End < Info->End) {
-    Len = End - Info->End;
+    Len = Info->End - End;
 
     NetbufTrim (Packet, (UINT32) Len, NET_BUF_TAIL);
     Info->End     = End;
@@ -331,17 +331,24 @@ Returns:
   //
   // Find the point to insert the packet: before the first
   // fragment with THIS.Start < CUR.Start. the previous one
-  // has PREV.Start <= THIS.Start < CUR.Start.
+  // has PREV.Start <= THIS.Start < CUR.Start. The fragments
+  // mostly arrive in order, so search backward from the tail,
+  // which makes appending a fragment O(1).
   //
   Head = &Assemble->Fragments;
+  Prev = Head->BackLink;
 
-  NET_LIST_FOR_EACH (Cur, Head) {
-    Fragment = NET_LIST_USER_STRUCT (Cur, NET_BUF, List);
+  while (Prev != Head) {
+    Fragment = NET_LIST_USER_STRUCT (Prev, NET_BUF, List);
 
-    if (This->Start < IP4_GET_CLIP_INFO (Fragment)->Start) {
+    if (IP4_GET_CLIP_INFO (Fragment)->Start <= This->Start) {
       break;
     }
+
+    Prev = Prev->BackLink;
   }
+
+  Cur = Prev->ForwardLink;
   
   //
   // Check whether the current fragment overlaps with the previous one.
@@ -349,7 +356,7 @@ Returns:
   // check whether THIS.Start < PREV.End for overlap. If two fragments
   // overlaps, trim the overlapped part off THIS fragment.
   //
-  if ((Prev = Cur->ForwardLink) != Head) {
+  if (Prev != Head) {
     Fragment  = NET_LIST_USER_STRUCT (Prev, NET_BUF, List);
     Node      = IP4_GET_CLIP_INFO (Fragment);
 
@@ -94,13 +94,423 @@ Returns:
   }
 }
 
+STATIC
+IP4_ROUTE_NODE *
+Ip4CreateRouteNode (
+  IN IP4_ADDR               Prefix,
+  IN UINT32                 Len,
+  IN IP4_ROUTE_ENTRY        *RtEntry
+  )
+/*++
+
+Routine Description:
+
+  Allocate a route trie node for the network Prefix/Len.
+
+Arguments:
+
+  Prefix  - The network prefix, the bits after Len are zero
+  Len     - The length of the network prefix
+  RtEntry - The route to the network, or NULL for a branch node
+
+Returns:
+
+  NULL if failed to allocate memory, otherwise the newly created
+  route trie node.
+
+--*/
+{
+  IP4_ROUTE_NODE            *Node;
+
+  Node = NetAllocatePool (sizeof (IP4_ROUTE_NODE));
+
+  if (Node == NULL) {
+    return NULL;
+  }
+
+  Node->Child[0]  = NULL;
+  Node->Child[1]  = NULL;
+  Node->Prefix    = Prefix;
+  Node->Len       = Len;
+  Node->Route     = RtEntry;
+
+  return Node;
+}
+
+STATIC
+VOID
+Ip4FreeRouteTrie (
+  IN IP4_ROUTE_NODE         *Node
+  )
+/*++
+
+Routine Description:
+
+  Free the route trie node and all its children. The route 
+  entries are owned by the route areas and not freed here.
+
+Arguments:
+
+  Node  - The root of the trie to free.
+
+Returns:
+
+  None
+
+--*/
+{
+  if (Node == NULL) {
+    return ;
+  }
+
+  Ip4FreeRouteTrie (Node->Child[0]);
+  Ip4FreeRouteTrie (Node->Child[1]);
+
+  NetFreePool (Node);
+}
+
+STATIC
+UINT32
+Ip4CommonPrefixLen (
+  IN IP4_ADDR               Addr1,
+  IN IP4_ADDR               Addr2,
+  IN UINT32                 Limit
+  )
+/*++
+
+Routine Description:
+
+  Get the number of leading bits that the two addresses 
+  have in common, not more than Limit.
+
+Arguments:
+
+  Addr1 - The first address
+  Addr2 - The second address
+  Limit - The maximum length to compare
+
+Returns:
+
+  The length of the common prefix.
+
+--*/
+{
+  UINT32                    Diff;
+  UINT32                    Len;
+
+  Diff = Addr1 ^ Addr2;
+
+  for (Len = 0; (Len < Limit) && ((Diff & (0x80000000 >> Len)) == 0); Len++) {
+    ;
+  }
+
+  return Len;
+}
+
+STATIC
+IP4_ROUTE_NODE *
+Ip4FindRouteNode (
+  IN IP4_ROUTE_NODE         *Node,
+  IN IP4_ADDR               Prefix,
+  IN UINT32                 Len
+  )
+/*++
+
+Routine Description:
+
+  Find the trie node for exactly the network Prefix/Len.
+
+Arguments:
+
+  Node    - The root of the route trie
+  Prefix  - The network prefix, the bits after Len are zero
+  Len     - The length of the network prefix
+
+Returns:
+
+  NULL if the network isn't in the trie, otherwise the node.
+
+--*/
+{
+  while ((Node != NULL) && (Node->Len <= Len)) {
+    if (!IP4_NET_EQUAL (Node->Prefix, Prefix, mIp4AllMasks[Node->Len])) {
+      return NULL;
+    }
+
+    if (Node->Len == Len) {
+      return Node;
+    }
+
+    Node = Node->Child[IP4_ROUTE_BIT (Prefix, Node->Len)];
+  }
+
+  return NULL;
+}
+
+STATIC
+EFI_STATUS
+Ip4InsertRouteNode (
+  IN IP4_ROUTE_TABLE        *RtTable,
+  IN IP4_ROUTE_ENTRY        *RtEntry,
+  IN UINT32                 Len
+  )
+/*++
+
+Routine Description:
+
+  Insert the route into the route trie. If there is a node for
+  the network already, the route replaces its route, as the
+  most recently added route is preferred.
+
+Arguments:
+
+  RtTable - The route table to insert the route into
+  RtEntry - The route to insert
+  Len     - The length of the route's netmask
+
+Returns:
+
+  EFI_OUT_OF_RESOURCES - Failed to allocate memory for the trie node
+  EFI_SUCCESS          - The route is inserted into the trie.
+
+--*/
+{
+  IP4_ROUTE_NODE            **Link;
+  IP4_ROUTE_NODE            *Node;
+  IP4_ROUTE_NODE            *New;
+  IP4_ROUTE_NODE            *Branch;
+  IP4_ADDR                  Prefix;
+  UINT32                    Common;
+
+  Prefix  = RtEntry->Dest & RtEntry->Netmask;
+  Link    = &RtTable->Trie;
+
+  while (*Link != NULL) {
+    Node    = *Link;
+    Common  = Ip4CommonPrefixLen (Prefix, Node->Prefix, NET_MIN (Len, Node->Len));
+
+    if (Common == Node->Len) {
+      if (Node->Len == Len) {
+        Node->Route = RtEntry;
+        return EFI_SUCCESS;
+      }
+
+      Link = &Node->Child[IP4_ROUTE_BIT (Prefix, Node->Len)];
+      continue;
+    }
+
+    //
+    // The network diverges from the node before the node's end. If
+    // the network contains the node, the new node becomes the node's
+    // parent. Otherwise, branch at the first different bit.
+    //
+    New = Ip4CreateRouteNode (Prefix, Len, RtEntry);
+
+    if (New == NULL) {
+      return EFI_OUT_OF_RESOURCES;
+    }
+
+    if (Common == Len) {
+      New->Child[IP4_ROUTE_BIT (Node->Prefix, Len)] = Node;
+      *Link = New;
+      return EFI_SUCCESS;
+    }
+
+    Branch = Ip4CreateRouteNode (Prefix & mIp4AllMasks[Common], Common, NULL);
+
+    if (Branch == NULL) {
+      NetFreePool (New);
+      return EFI_OUT_OF_RESOURCES;
+    }
+
+    Branch->Child[IP4_ROUTE_BIT (Prefix, Common)]       = New;
+    Branch->Child[IP4_ROUTE_BIT (Node->Prefix, Common)] = Node;
+    *Link = Branch;
+    return EFI_SUCCESS;
+  }
+
+  New = Ip4CreateRouteNode (Prefix, Len, RtEntry);
+
+  if (New == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  *Link = New;
+  return EFI_SUCCESS;
+}
+
+STATIC
+VOID
+Ip4RemoveRouteNode (
+  IN IP4_ROUTE_TABLE        *RtTable,
+  IN IP4_ADDR               Prefix,
+  IN UINT32                 Len,
+  IN IP4_ROUTE_ENTRY        *Replacement
+  )
+/*++
+
+Routine Description:
+
+  Replace the route of the trie node for the network Prefix/Len,
+  which must exist. If there is no replacement, the node is removed
+  unless it still branches.
+
+Arguments:
+
+  RtTable     - The route table to remove the route from
+  Prefix      - The network prefix, the bits after Len are zero
+  Len         - The length of the network prefix
+  Replacement - Another route to the same network, or NULL
+
+Returns:
+
+  None
+
+--*/
+{
+  IP4_ROUTE_NODE            **ParentLink;
+  IP4_ROUTE_NODE            **Link;
+  IP4_ROUTE_NODE            *Parent;
+  IP4_ROUTE_NODE            *Node;
+  IP4_ROUTE_NODE            *Child;
+
+  ParentLink  = NULL;
+  Link        = &RtTable->Trie;
+  Node        = *Link;
+
+  while ((Node != NULL) && (Node->Len < Len)) {
+    ParentLink  = Link;
+    Link        = &Node->Child[IP4_ROUTE_BIT (Prefix, Node->Len)];
+    Node        = *Link;
+  }
+
+  ASSERT ((Node != NULL) && (Node->Len == Len) && (Node->Prefix == Prefix));
+
+  Node->Route = Replacement;
+
+  if ((Replacement != NULL) || ((Node->Child[0] != NULL) && (Node->Child[1] != NULL))) {
+    return ;
+  }
+
+  //
+  // Remove the node which neither holds a route nor branches. If
+  // it is a leaf, its parent may be left as such a node too.
+  //
+  Child = Node->Child[0];
+
+  if (Child == NULL) {
+    Child = Node->Child[1];
+  }
+
+  *Link = Child;
+  NetFreePool (Node);
+
+  if ((Child != NULL) || (ParentLink == NULL)) {
+    return ;
+  }
+
+  Parent = *ParentLink;
+
+  if (Parent->Route == NULL) {
+    Child = Parent->Child[0];
+
+    if (Child == NULL) {
+      Child = Parent->Child[1];
+    }
+
+    *ParentLink = Child;
+    NetFreePool (Parent);
+  }
+}
+
+STATIC
+IP4_ROUTE_NODE *
+Ip4LookupRouteNode (
+  IN IP4_ROUTE_NODE         *Node,
+  IN IP4_ADDR               Dst
+  )
+/*++
+
+Routine Description:
+
+  Find the trie node with the longest network that contains Dst
+  and holds a route.
+
+Arguments:
+
+  Node  - The root of the route trie
+  Dst   - The destination address to search
+
+Returns:
+
+  NULL if no route matches Dst, otherwise the matched node.
+
+--*/
+{
+  IP4_ROUTE_NODE            *Match;
+
+  Match = NULL;
+
+  while (Node != NULL) {
+    if (!IP4_NET_EQUAL (Node->Prefix, Dst, mIp4AllMasks[Node->Len])) {
+      break;
+    }
+
+    if (Node->Route != NULL) {
+      Match = Node;
+    }
+
+    if (Node->Len == IP4_MASK_NUM - 1) {
+      break;
+    }
+
+    Node = Node->Child[IP4_ROUTE_BIT (Dst, Node->Len)];
+  }
+
+  return Match;
+}
+
+STATIC
+UINT32
+Ip4RouteGeneration (
+  IN IP4_ROUTE_TABLE        *RtTable
+  )
+/*++
+
+Routine Description:
+
+  Get the generation of the route tables searched by the route
+  table's route cache, that is, the table and those linked after
+  it. It increases whenever any of the tables is changed.
+
+Arguments:
+
+  RtTable - The route table that owns the route cache
+
+Returns:
+
+  The generation of the route tables.
+
+--*/
+{
+  UINT32                    Generation;
+
+  Generation = 0;
+
+  for (; RtTable != NULL; RtTable = RtTable->Next) {
+    Generation += RtTable->Generation;
+  }
+
+  return Generation;
+}
+
 STATIC
 IP4_ROUTE_CACHE_ENTRY *
 Ip4CreateRouteCacheEntry (
   IN IP4_ADDR               Dst,
   IN IP4_ADDR               Src,
   IN IP4_ADDR               GateWay,
-  IN UINTN                  Tag
+  IN UINT32                 Generation
   )
 /*++
 
@@ -110,11 +520,11 @@ Routine Description:
 
 Arguments:
 
-  Dst     - The destination address
-  Src     - The source address
-  GateWay - The next hop address
-  Tag     - The tag from the caller. This marks all the cache entries
-            spawned from one route table entry.
+  Dst        - The destination address
+  Src        - The source address
+  GateWay    - The next hop address
+  Generation - The generation of the route tables the next 
+               hop is computed from.
 
 Returns:
 
@@ -136,8 +546,8 @@ Returns:
   RtCacheEntry->RefCnt  = 1;
   RtCacheEntry->Dest    = Dst;
   RtCacheEntry->Src     = Src;
-  RtCacheEntry->NextHop = GateWay;
-  RtCacheEntry->Tag     = Tag;
+  RtCacheEntry->NextHop    = GateWay;
+  RtCacheEntry->Generation = Generation;
 
   return RtCacheEntry;
 }
@@ -263,8 +673,10 @@ Returns:
     return NULL;
   }
 
-  RtTable->RefCnt   = 1;
-  RtTable->TotalNum = 0;
+  RtTable->RefCnt     = 1;
+  RtTable->TotalNum   = 0;
+  RtTable->Trie       = NULL;
+  RtTable->Generation = 0;
 
   for (Index = 0; Index < IP4_MASK_NUM; Index++) {
     NetListInit (&(RtTable->RouteArea[Index]));
@@ -320,56 +732,12 @@ Returns:
     }
   }
 
+  Ip4FreeRouteTrie (RtTable->Trie);
   Ip4CleanRouteCache (&RtTable->Cache);
   
   NetFreePool (RtTable);
 }
 
-
-STATIC
-VOID
-Ip4PurgeRouteCache (
-  IN IP4_ROUTE_CACHE        *RtCache,
-  IN UINTN                  Tag
-  )
-/*++
-
-Routine Description:
-
-  Remove all the cache entries bearing the Tag. When a route cache
-  entry is created, it is tagged with the address of route entry 
-  from which it is spawned. When a route entry is deleted, the cache
-  entries spawned from it are also deleted.
-
-Arguments:
-
-  RtCache - Route cache to remove the entries from
-  Tag     - The Tag of the entries to remove
-
-Returns:
-
-  None
-
---*/
-{
-  NET_LIST_ENTRY            *Entry;
-  NET_LIST_ENTRY            *Next;
-  IP4_ROUTE_CACHE_ENTRY     *RtCacheEntry;
-  UINT32                    Index;
-
-  for (Index = 0; Index < IP4_ROUTE_CACHE_HASH; Index++) {
-    NET_LIST_FOR_EACH_SAFE (Entry, Next, &RtCache->CacheBucket[Index]) {
-
-      RtCacheEntry = NET_LIST_USER_STRUCT (Entry, IP4_ROUTE_CACHE_ENTRY, Link);
-
-      if (RtCacheEntry->Tag == Tag) {
-        NetListRemoveEntry (Entry);
-        Ip4FreeRouteCacheEntry (RtCacheEntry);
-      }
-    }
-  }
-}
-
 EFI_STATUS
 Ip4AddRoute (
   IN IP4_ROUTE_TABLE        *RtTable,
@@ -402,21 +770,29 @@ Returns:
   NET_LIST_ENTRY            *Head;
   NET_LIST_ENTRY            *Entry;
   IP4_ROUTE_ENTRY           *RtEntry;
+  IP4_ROUTE_NODE            *Node;
+  UINT32                    Len;
 
   //
   // All the route entries with the same netmask length are 
   // linke to the same route area
   //
-  Head = &(RtTable->RouteArea[NetGetMaskLength (Netmask)]);
+  Len   = (UINT32) NetGetMaskLength (Netmask);
+  Head  = &(RtTable->RouteArea[Len]);
 
   //
-  // First check whether the route exists
+  // First check whether the route exists. The route area
+  // needs to be searched only if the trie has the network.
   //
-  NET_LIST_FOR_EACH (Entry, Head) {
-    RtEntry = NET_LIST_USER_STRUCT (Entry, IP4_ROUTE_ENTRY, Link);
+  Node = Ip4FindRouteNode (RtTable->Trie, Dest & Netmask, Len);
 
-    if (IP4_NET_EQUAL (RtEntry->Dest, Dest, Netmask) && (RtEntry->NextHop == Gateway)) {
-      return EFI_ACCESS_DENIED;
+  if ((Node != NULL) && (Node->Route != NULL)) {
+    NET_LIST_FOR_EACH (Entry, Head) {
+      RtEntry = NET_LIST_USER_STRUCT (Entry, IP4_ROUTE_ENTRY, Link);
+
+      if (IP4_NET_EQUAL (RtEntry->Dest, Dest, Netmask) && (RtEntry->NextHop == Gateway)) {
+        return EFI_ACCESS_DENIED;
+      }
     }
   }
   
@@ -433,8 +809,14 @@ Returns:
     RtEntry->Flag = IP4_DIRECT_ROUTE;
   }
 
+  if (EFI_ERROR (Ip4InsertRouteNode (RtTable, RtEntry, Len))) {
+    Ip4FreeRouteEntry (RtEntry);
+    return EFI_OUT_OF_RESOURCES;
+  }
+
   NetListInsertHead (Head, &RtEntry->Link);
   RtTable->TotalNum++;
+  RtTable->Generation++;
 
   return EFI_SUCCESS;
 }
@@ -470,18 +852,48 @@ Returns:
   NET_LIST_ENTRY            *Entry;
   NET_LIST_ENTRY            *Next;
   IP4_ROUTE_ENTRY           *RtEntry;
+  IP4_ROUTE_ENTRY           *Replacement;
+  IP4_ROUTE_NODE            *Node;
+  UINT32                    Len;
 
-  Head = &(RtTable->RouteArea[NetGetMaskLength (Netmask)]);
+  Len   = (UINT32) NetGetMaskLength (Netmask);
+  Head  = &(RtTable->RouteArea[Len]);
+  Node  = Ip4FindRouteNode (RtTable->Trie, Dest & Netmask, Len);
+
+  if ((Node == NULL) || (Node->Route == NULL)) {
+    return EFI_NOT_FOUND;
+  }
 
   NET_LIST_FOR_EACH_SAFE (Entry, Next, Head) {
     RtEntry = NET_LIST_USER_STRUCT (Entry, IP4_ROUTE_ENTRY, Link);
 
     if (IP4_NET_EQUAL (RtEntry->Dest, Dest, Netmask) && (RtEntry->NextHop == Gateway)) {
-      Ip4PurgeRouteCache (&RtTable->Cache, (UINTN) RtEntry);
       NetListRemoveEntry (Entry);
+
+      //
+      // If the trie uses this route, the most recently added
+      // other route to the same network, if any, takes over.
+      //
+      if (Node->Route == RtEntry) {
+        Replacement = NULL;
+
+        NET_LIST_FOR_EACH (Entry, Head) {
+          Replacement = NET_LIST_USER_STRUCT (Entry, IP4_ROUTE_ENTRY, Link);
+
+          if (IP4_NET_EQUAL (Replacement->Dest, Dest, Netmask)) {
+            break;
+          }
+
+          Replacement = NULL;
+        }
+
+        Ip4RemoveRouteNode (RtTable, Dest & Netmask, Len, Replacement);
+      }
+
       Ip4FreeRouteEntry  (RtEntry);
 
       RtTable->TotalNum--;
+      RtTable->Generation++;
       return EFI_SUCCESS;
     }
   }
@@ -502,7 +914,8 @@ Routine Description:
   Find a route cache with the dst and src. This is used by ICMP 
   redirect messasge process. All kinds of redirect is treated as 
   host redirect according to RFC1122. So, only route cache entries
-  are modified according to the ICMP redirect message.
+  are modified according to the ICMP redirect message. The entry
+  created before the last change to the route tables is removed.
 
 Arguments:
 
@@ -527,6 +940,12 @@ Returns:
     RtCacheEntry = NET_LIST_USER_STRUCT (Entry, IP4_ROUTE_CACHE_ENTRY, Link);
 
     if ((RtCacheEntry->Dest == Dest) && (RtCacheEntry->Src == Src)) {
+      if (RtCacheEntry->Generation != Ip4RouteGeneration (RtTable)) {
+        NetListRemoveEntry (Entry);
+        Ip4FreeRouteCacheEntry (RtCacheEntry);
+        return NULL;
+      }
+
       NET_GET_REF (RtCacheEntry);
       return RtCacheEntry;
     }
@@ -546,10 +965,9 @@ Ip4FindRouteEntry (
 Routine Description:
 
   Search the route table for a most specific match to the Dst. It searches 
-  from the longest route area (mask length == 32) to the shortest route area (
-  default routes). In each route area, it will first search the instance's 
-  route table, then the default route table. This is required by the following
-  requirements:
+  the trie of the instance's route table, then that of the default route
+  table, and only takes the latter's match if it is longer. This is 
+  required by the following requirements:
     1. IP search the route table for a most specific match
     2. The local route entries have precedence over the default route entry.
 
@@ -565,28 +983,26 @@ Returns:
 
 --*/
 {
-  NET_LIST_ENTRY            *Entry;
-  IP4_ROUTE_ENTRY           *RtEntry;
+  IP4_ROUTE_NODE            *Node;
+  IP4_ROUTE_NODE            *Match;
   IP4_ROUTE_TABLE           *Table;
-  INTN                      Index;
 
-  RtEntry = NULL;
-    
-  for (Index = IP4_MASK_NUM - 1; Index >= 0; Index--) {
-    for (Table = RtTable; Table != NULL; Table = Table->Next) {
-      NET_LIST_FOR_EACH (Entry, &Table->RouteArea[Index]) {
-        RtEntry = NET_LIST_USER_STRUCT (Entry, IP4_ROUTE_ENTRY, Link);
-        
-        if (IP4_NET_EQUAL (RtEntry->Dest, Dst, RtEntry->Netmask)) {
-          NET_GET_REF (RtEntry);
-          return RtEntry;
-        }      
-      }
+  Match = NULL;
+
+  for (Table = RtTable; Table != NULL; Table = Table->Next) {
+    Node = Ip4LookupRouteNode (Table->Trie, Dst);
+
+    if ((Node != NULL) && ((Match == NULL) || (Node->Len > Match->Len))) {
+      Match = Node;
     }
   }
 
+  if (Match == NULL) {
+    return NULL;
+  }
 
-  return NULL;
+  NET_GET_REF (Match->Route);
+  return Match->Route;
 }
 
 IP4_ROUTE_CACHE_ENTRY *
@@ -662,9 +1078,9 @@ Returns:
   Ip4FreeRouteEntry (RtEntry);
 
   //
-  // Create a route cache entry, and tag it as spawned from this route entry
+  // Create a route cache entry valid until the route tables change
   //
-  RtCacheEntry = Ip4CreateRouteCacheEntry (Dest, Src, NextHop, (UINTN) RtEntry);
+  RtCacheEntry = Ip4CreateRouteCacheEntry (Dest, Src, NextHop, Ip4RouteGeneration (RtTable));
 
   if (RtCacheEntry == NULL) {
     return NULL;
@@ -34,6 +34,12 @@ enum {
 
 #define IP4_ROUTE_CACHE_HASH(Dst, Src)  (((Dst) ^ (Src)) % IP4_ROUTE_CACHE_HASH)
 
+//
+// The bit of the host byte order address at Pos, counting from the
+// most significant bit. It selects the child of a route trie node.
+//
+#define IP4_ROUTE_BIT(Addr, Pos)        ((UINT32) ((Addr) >> (31 - (Pos))) & 0x01)
+
 //
 // The route entry in the route table. Dest/Netmask is the destion 
 // network. The nexthop is the gateway to send the packet to in 
@@ -50,15 +56,31 @@ typedef struct {
   UINT32                    Flag;
 } IP4_ROUTE_ENTRY;
 
+//
+// The node of the route trie. The trie is a path compressed binary
+// trie, a node exists only if it holds a route or has two children.
+// The node covers the network Prefix/Len, its children cover the
+// networks longer than Len whose bit at Len is 0 or 1. Route is the
+// most recently added route to exactly Prefix/Len, or NULL if the
+// node only branches.
+//
+typedef struct _IP4_ROUTE_NODE  IP4_ROUTE_NODE;
+
+struct _IP4_ROUTE_NODE {
+  IP4_ROUTE_NODE            *Child[2];
+  IP4_ADDR                  Prefix;
+  UINT32                    Len;
+  IP4_ROUTE_ENTRY           *Route;
+};
+
 //
 // The route cache entry. The route cache entry is optional. 
 // But it is necessary to support the ICMP redirect message.
 // Check Ip4ProcessIcmpRedirect for information. 
 //
-// The cache entry field Tag is used to tag all the route 
-// cache entry spawned from a route table entry. This makes 
-// it simple to delete all the route cache entries from a 
-// to-be-deleted route entry.
+// The cache entry field Generation is the generation of the
+// route tables when the entry is created. Any change to the
+// route tables invalidates the entries created before it.
 //
 typedef struct {
   NET_LIST_ENTRY            Link;
@@ -66,7 +88,7 @@ typedef struct {
   IP4_ADDR                  Dest;
   IP4_ADDR                  Src;
   IP4_ADDR                  NextHop;
-  UINTN                     Tag;
+  UINT32                    Generation;
 } IP4_ROUTE_CACHE_ENTRY;
 
 //
@@ -86,7 +108,10 @@ typedef struct {
 //
 // All the route table entries with the same mask are linked 
 // together in one route area. For example, RouteArea[0] contains
-// the default routes. A route table also contains a route cache.
+// the default routes. The routes are also indexed by the trie for
+// the longest prefix match. A route table also contains a route
+// cache. Generation is increased each time a route is added or
+// removed.
 //
 typedef struct _IP4_ROUTE_TABLE IP4_ROUTE_TABLE;
 
@@ -94,6 +119,8 @@ typedef struct _IP4_ROUTE_TABLE {
   INTN                      RefCnt;
   UINT32                    TotalNum;
   NET_LIST_ENTRY            RouteArea[IP4_MASK_NUM];
+  IP4_ROUTE_NODE            *Trie;
+  UINT32                    Generation;
   IP4_ROUTE_TABLE           *Next;
   IP4_ROUTE_CACHE           Cache;
 };
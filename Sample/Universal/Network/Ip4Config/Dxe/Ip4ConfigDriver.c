@@ -520,6 +520,7 @@ Ip4ConfigDriverBindingStop (
   Ip4ConfigCleanConfig (Instance);
   mIp4ConfigNicList[Instance->NicIndex] = NULL;
   NetFreePool (Instance);
+  NetbufCacheFlush ();
 
   return EFI_SUCCESS;
 }
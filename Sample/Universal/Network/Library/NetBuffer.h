@@ -178,6 +178,11 @@ NetbufFree (
   IN NET_BUF                *Nbuf
   );
 
+VOID
+NetbufCacheFlush (
+  VOID
+  );
+
 
 UINT8  *
 NetbufGetByte (
@@ -322,6 +327,13 @@ NetAddChecksum (
   IN UINT16                 Checksum2
   );
 
+UINT16
+NetUpdateChecksum (
+  IN UINT16                 Checksum,
+  IN UINT16                 OldValue,
+  IN UINT16                 NewValue
+  );
+
 UINT16
 NetbufChecksum (
   IN NET_BUF                *Nbuf
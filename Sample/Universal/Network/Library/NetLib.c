@@ -19,6 +19,7 @@ Abstract:
 --*/
 
 #include "NetLib.h"
+#include "NetBuffer.h"
 
 EFI_DPC_PROTOCOL *mDpc = NULL;
 
@@ -1155,6 +1156,8 @@ Returns:
     gBS->FreePool (DeviceHandleBuffer);
   }
 
+  NetbufCacheFlush ();
+
   return EFI_SUCCESS;
 }
 
@@ -20,6 +20,147 @@ Abstract:
 
 #include "NetBuffer.h"
 
+//
+// Freed single block NET_BUFs and NET_VECTORs, the ones used by every
+// NetbufAlloc and most clones, are kept on these lists instead of going
+// back to the pool. Each cached object is still a pool allocation, so it
+// may also be released with NetFreePool. The link is stored over the
+// object's signature.
+//
+#define NET_BUF_CACHE_MAX   128
+
+typedef struct _NET_CACHE_ENTRY {
+  struct _NET_CACHE_ENTRY   *Next;
+} NET_CACHE_ENTRY;
+
+STATIC NET_CACHE_ENTRY      *mNetbufCache       = NULL;
+STATIC UINTN                mNetbufCacheNum     = 0;
+STATIC NET_CACHE_ENTRY      *mNetVectorCache    = NULL;
+STATIC UINTN                mNetVectorCacheNum  = 0;
+
+STATIC
+VOID *
+NetCacheAlloc (
+  IN OUT NET_CACHE_ENTRY    **Cache,
+  IN OUT UINTN              *CacheNum,
+  IN UINTN                  Size
+  )
+/*++
+
+Routine Description:
+
+  Take an object from the cache, or allocate one from the pool if the
+  cache is empty. The object isn't zeroed.
+
+Arguments:
+
+  Cache    - Pointer to the head of the cache.
+  CacheNum - Pointer to the number of objects in the cache.
+  Size     - The size of the objects in the cache.
+
+Returns:
+
+  VOID * - Pointer to the object, NULL if out of memory.
+
+--*/
+{
+  NET_CACHE_ENTRY           *Entry;
+  EFI_TPL                   OldTpl;
+
+  //
+  // Net buffers are released from the recycle events, so the cache is
+  // only touched at NET_TPL_RECYCLE.
+  //
+  OldTpl = NET_RAISE_TPL (NET_TPL_RECYCLE);
+
+  Entry = *Cache;
+  if (Entry != NULL) {
+    *Cache = Entry->Next;
+    (*CacheNum)--;
+  }
+
+  NET_RESTORE_TPL (OldTpl);
+
+  if (Entry == NULL) {
+    return NetAllocatePool (Size);
+  }
+
+  return Entry;
+}
+
+STATIC
+VOID
+NetCacheFree (
+  IN OUT NET_CACHE_ENTRY    **Cache,
+  IN OUT UINTN              *CacheNum,
+  IN VOID                   *Object
+  )
+/*++
+
+Routine Description:
+
+  Put an object back to the cache, or to the pool if the cache is full.
+
+Arguments:
+
+  Cache    - Pointer to the head of the cache.
+  CacheNum - Pointer to the number of objects in the cache.
+  Object   - Pointer to the object to free.
+
+Returns:
+
+  None.
+
+--*/
+{
+  NET_CACHE_ENTRY           *Entry;
+  EFI_TPL                   OldTpl;
+
+  Entry  = (NET_CACHE_ENTRY *) Object;
+  OldTpl = NET_RAISE_TPL (NET_TPL_RECYCLE);
+
+  if (*CacheNum < NET_BUF_CACHE_MAX) {
+    Entry->Next = *Cache;
+    *Cache      = Entry;
+    (*CacheNum)++;
+    Entry       = NULL;
+  }
+
+  NET_RESTORE_TPL (OldTpl);
+
+  if (Entry != NULL) {
+    NetFreePool (Entry);
+  }
+}
+
+STATIC
+VOID
+NetbufFreeStruct (
+  IN NET_BUF                *Nbuf
+  )
+/*++
+
+Routine Description:
+
+  Release the NET_BUF structure itself, leaving its NET_VECTOR alone.
+
+Arguments:
+
+  Nbuf - Pointer to the NET_BUF to release.
+
+Returns:
+
+  None.
+
+--*/
+{
+  if (Nbuf->BlockOpNum == 1) {
+    NetCacheFree (&mNetbufCache, &mNetbufCacheNum, Nbuf);
+  } else {
+    NetFreePool (Nbuf);
+  }
+}
+
 STATIC
 NET_BUF *
 NetbufAllocStruct (
@@ -53,7 +194,14 @@ Returns:
   //
   // Allocate three memory blocks.
   //
-  Nbuf = NetAllocateZeroPool (NET_BUF_SIZE (BlockOpNum));
+  if (BlockOpNum == 1) {
+    Nbuf = NetCacheAlloc (&mNetbufCache, &mNetbufCacheNum, NET_BUF_SIZE (1));
+    if (Nbuf != NULL) {
+      NetZeroMem (Nbuf, NET_BUF_SIZE (1));
+    }
+  } else {
+    Nbuf = NetAllocateZeroPool (NET_BUF_SIZE (BlockOpNum));
+  }
 
   if (Nbuf == NULL) {
     return NULL;
@@ -65,7 +213,14 @@ Returns:
   NetListInit (&Nbuf->List);
  
   if (BlockNum != 0) {
-    Vector = NetAllocateZeroPool (NET_VECTOR_SIZE (BlockNum));
+    if (BlockNum == 1) {
+      Vector = NetCacheAlloc (&mNetVectorCache, &mNetVectorCacheNum, NET_VECTOR_SIZE (1));
+      if (Vector != NULL) {
+        NetZeroMem (Vector, NET_VECTOR_SIZE (1));
+      }
+    } else {
+      Vector = NetAllocateZeroPool (NET_VECTOR_SIZE (BlockNum));
+    }
 
     if (Vector == NULL) {
       goto FreeNbuf;
@@ -81,7 +236,7 @@ Returns:
   
 FreeNbuf:
   
-  NetFreePool (Nbuf);
+  NetbufFreeStruct (Nbuf);
   return NULL;
 }
 
@@ -141,7 +296,8 @@ Returns:
   return Nbuf;
 
 FreeNBuf:
-  NetFreePool (Nbuf);
+  NetCacheFree (&mNetVectorCache, &mNetVectorCacheNum, Nbuf->Vector);
+  NetbufFreeStruct (Nbuf);
   return NULL;
 }
 
@@ -199,7 +355,11 @@ Returns:
     }
   }
 
-  NetFreePool (Vector);
+  if (Vector->BlockNum == 1) {
+    NetCacheFree (&mNetVectorCache, &mNetVectorCacheNum, Vector);
+  } else {
+    NetFreePool (Vector);
+  }
 }
 
 VOID
@@ -233,7 +393,58 @@ Returns:
     // all the sharing of Nbuf increse Vector's RefCnt by one
     //
     NetbufFreeVector (Nbuf->Vector);
-    NetFreePool (Nbuf);
+    NetbufFreeStruct (Nbuf);
+  }
+}
+
+VOID
+NetbufCacheFlush (
+  VOID
+  )
+/*++
+
+Routine Description:
+
+  Return all the cached NET_BUF and NET_VECTOR structures to the pool.
+  Each driver linked with the library has its own cache, so it should be
+  flushed when the driver stops its last controller or is unloaded.
+
+Arguments:
+
+  None.
+
+Returns:
+
+  None.
+
+--*/
+{
+  NET_CACHE_ENTRY           *NetbufList;
+  NET_CACHE_ENTRY           *VectorList;
+  NET_CACHE_ENTRY           *Entry;
+  EFI_TPL                   OldTpl;
+
+  OldTpl = NET_RAISE_TPL (NET_TPL_RECYCLE);
+
+  NetbufList          = mNetbufCache;
+  VectorList          = mNetVectorCache;
+  mNetbufCache        = NULL;
+  mNetbufCacheNum     = 0;
+  mNetVectorCache     = NULL;
+  mNetVectorCacheNum  = 0;
+
+  NET_RESTORE_TPL (OldTpl);
+
+  while (NetbufList != NULL) {
+    Entry       = NetbufList;
+    NetbufList  = Entry->Next;
+    NetFreePool (Entry);
+  }
+
+  while (VectorList != NULL) {
+    Entry       = VectorList;
+    VectorList  = Entry->Next;
+    NetFreePool (Entry);
   }
 }
 
@@ -261,7 +472,11 @@ Returns:
 
   NET_CHECK_SIGNATURE (Nbuf, NET_BUF_SIGNATURE);
 
-  Clone = NetAllocatePool (NET_BUF_SIZE (Nbuf->BlockOpNum));
+  if (Nbuf->BlockOpNum == 1) {
+    Clone = NetCacheAlloc (&mNetbufCache, &mNetbufCacheNum, NET_BUF_SIZE (1));
+  } else {
+    Clone = NetAllocatePool (NET_BUF_SIZE (Nbuf->BlockOpNum));
+  }
 
   if (Clone == NULL) {
     return NULL;
@@ -739,7 +954,7 @@ Returns:
   
 FreeChild:
   
-  NetFreePool (Child);
+  NetbufFreeStruct (Child);
   return NULL;
 }
 
@@ -1778,10 +1993,44 @@ Returns:
 
 --*/
 {
-  register UINT32           Sum;
+  UINT64                    Sum;
+  UINT32                    *Word;
+  UINT32                    Sum32;
 
   Sum = 0;
 
+  //
+  // Sum the data a UINT32 at a time into a 64-bit accumulator, the carries
+  // are folded back once at the end. An odd address can't be aligned without
+  // changing the byte pairing, leave it to the UINT16 loop.
+  //
+  if (((UINTN) Bulk & 0x01) == 0) {
+    if ((((UINTN) Bulk & 0x02) != 0) && (Len > 1)) {
+      Sum  += *(UINT16 *) Bulk;
+      Bulk += 2;
+      Len  -= 2;
+    }
+
+    Word = (UINT32 *) Bulk;
+
+    while (Len >= 16) {
+      Sum  += Word[0];
+      Sum  += Word[1];
+      Sum  += Word[2];
+      Sum  += Word[3];
+      Word += 4;
+      Len  -= 16;
+    }
+
+    while (Len >= 4) {
+      Sum += *Word;
+      Word++;
+      Len -= 4;
+    }
+
+    Bulk = (UINT8 *) Word;
+  }
+
   while (Len > 1) {
     Sum += *(UINT16 *) Bulk;
     Bulk += 2;
@@ -1796,14 +2045,16 @@ Returns:
   }
 
   //
-  // Fold 32-bit sum to 16 bits
+  // Fold 64-bit sum to 32 bits, then to 16 bits
   //
-  while (Sum >> 16) {
-    Sum = (Sum & 0xffff) + (Sum >> 16);
+  Sum   = (Sum & 0xffffffff) + RShiftU64 (Sum, 32);
+  Sum32 = (UINT32) Sum + (UINT32) RShiftU64 (Sum, 32);
 
+  while (Sum32 >> 16) {
+    Sum32 = (Sum32 & 0xffff) + (Sum32 >> 16);
   }
 
-  return (UINT16) Sum;
+  return (UINT16) Sum32;
 }
 
 UINT16
@@ -1843,6 +2094,44 @@ Returns:
   return (UINT16) Sum;
 }
 
+UINT16
+NetUpdateChecksum (
+  IN UINT16                 Checksum,
+  IN UINT16                 OldValue,
+  IN UINT16                 NewValue
+  )
+/*++
+
+Routine Description:
+
+  Update a checksum field after a 16-bit word it covers changes from
+  OldValue to NewValue, without summing the data again. This is
+  HC' = ~(~HC + ~m + m') from RFC 1624.
+
+Arguments:
+
+  Checksum - The checksum field as stored in the packet.
+  OldValue - The old value of the word, as stored in the packet.
+  NewValue - The new value of the word, as stored in the packet.
+
+Returns:
+
+  UINT16   - The new value of the checksum field.
+
+--*/
+{
+  UINT32                    Sum;
+
+  Sum = (UINT16) ~Checksum;
+  Sum = Sum + (UINT16) ~OldValue + NewValue;
+
+  while (Sum >> 16) {
+    Sum = (Sum & 0xffff) + (Sum >> 16);
+  }
+
+  return (UINT16) ~Sum;
+}
+
 UINT16
 NetbufChecksum (
   IN NET_BUF                *Nbuf
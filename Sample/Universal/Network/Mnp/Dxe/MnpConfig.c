@@ -351,6 +351,9 @@ Returns:
   //
   NetListInit (&MnpServiceData->GroupAddressList);
   NetListInit (&MnpServiceData->ChildrenList);
+  NetListInit (&MnpServiceData->TxPendingList);
+  NetListInit (&MnpServiceData->FreeTxEntryList);
+  NetListInit (&MnpServiceData->FreeRxDataWrapList);
 
   //
   // Get the buffer length used to allocate NET_BUF to hold data received
@@ -384,18 +387,6 @@ Returns:
     NET_BUF_TAIL
     );
 
-  //
-  // Allocate buffer pool for tx.
-  //
-  MnpServiceData->TxBuf = NetAllocatePool (MnpServiceData->Mtu + SnpMode->MediaHeaderSize);
-  if (MnpServiceData->TxBuf == NULL) {
-
-    MNP_DEBUG_ERROR (("MnpInitializeServiceData: NetAllocatePool failed.\n"));
-    Status = EFI_OUT_OF_RESOURCES;
-
-    goto ERROR;
-  }
-
   //
   // Create the system poll timer.
   //
@@ -459,11 +450,6 @@ ERROR:
       gBS->CloseEvent (MnpServiceData->PollTimer);
     }
 
-    if (MnpServiceData->TxBuf != NULL) {
-
-      NetFreePool (MnpServiceData->TxBuf);
-    }
-
     if (MnpServiceData->RxNbufCache != NULL) {
 
       MnpFreeNbuf (MnpServiceData, MnpServiceData->RxNbufCache);
@@ -498,6 +484,9 @@ Returns:
 
 --*/
 {
+  MNP_TX_ENTRY    *TxEntry;
+  MNP_RXDATA_WRAP *RxDataWrap;
+
   NET_CHECK_SIGNATURE (MnpServiceData, MNP_SERVICE_DATA_SIGNATURE);
 
   //
@@ -513,9 +502,26 @@ Returns:
   gBS->CloseEvent (&MnpServiceData->PollTimer);
 
   //
-  // Free the tx buffer.
+  // Free the tx entries.
+  //
+  ASSERT (NetListIsEmpty (&MnpServiceData->TxPendingList));
+  while (!NetListIsEmpty (&MnpServiceData->FreeTxEntryList)) {
+    TxEntry = NET_LIST_HEAD (&MnpServiceData->FreeTxEntryList, MNP_TX_ENTRY, Entry);
+    NetListRemoveEntry (&TxEntry->Entry);
+    NetFreePool (TxEntry);
+  }
+
+  //
+  // Free the cached rx data wraps.
   //
-  NetFreePool (MnpServiceData->TxBuf);
+  while (!NetListIsEmpty (&MnpServiceData->FreeRxDataWrapList)) {
+    RxDataWrap = NET_LIST_HEAD (&MnpServiceData->FreeRxDataWrapList, MNP_RXDATA_WRAP, WrapEntry);
+    NetListRemoveEntry (&RxDataWrap->WrapEntry);
+    gBS->CloseEvent (RxDataWrap->RxData.RecycleEvent);
+    NetFreePool (RxDataWrap);
+  }
+
+  MnpServiceData->FreeRxDataWrapCount = 0;
 
   //
   // Free the RxNbufCache.
@@ -864,7 +870,8 @@ Returns:
       goto ErrorExit;
     }
 
-    MnpServiceData->EnableSystemPoll = EnableSystemPoll;
+    MnpServiceData->EnableSystemPoll  = EnableSystemPoll;
+    MnpServiceData->PollInterval      = MNP_SYS_POLL_INTERVAL;
   }
 
   //
@@ -939,6 +946,12 @@ Returns:
   //
   Status  = gBS->SetTimer (MnpServiceData->TimeoutCheckTimer, TimerCancel, 0);
 
+  //
+  // The simple network won't recycle the pending transmit buffers once
+  // it's stopped, release them now.
+  //
+  MnpFlushTxQueue (MnpServiceData);
+
   //
   // Stop the simple network.
   //
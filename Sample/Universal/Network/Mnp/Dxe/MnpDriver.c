@@ -264,6 +264,7 @@ Returns:
     MnpFlushServiceData (MnpServiceData);
 
     NetFreePool (MnpServiceData);
+    NetbufCacheFlush ();
   } else {
     while (!NetListIsEmpty (&MnpServiceData->ChildrenList)) {
       //
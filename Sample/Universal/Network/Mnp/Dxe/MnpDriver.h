@@ -73,6 +73,7 @@ typedef struct _MNP_SERVICE_DATA {
 
   EFI_EVENT                     PollTimer;
   BOOLEAN                       EnableSystemPoll;
+  UINT64                        PollInterval;
 
   EFI_EVENT                     TimeoutCheckTimer;
 
@@ -88,7 +89,20 @@ typedef struct _MNP_SERVICE_DATA {
   UINT32                        BufferLength;
   UINT32                        PaddingSize;
   NET_BUF                       *RxNbufCache;
-  UINT8                         *TxBuf;
+
+  //
+  // Transmits handed to SNP whose buffers are not recycled yet, and the
+  // transmit entries kept for reuse.
+  //
+  NET_LIST_ENTRY                TxPendingList;
+  UINTN                         TxPendingCount;
+  NET_LIST_ENTRY                FreeTxEntryList;
+
+  //
+  // Recycled receive wraps, each still owning its recycle event.
+  //
+  NET_LIST_ENTRY                FreeRxDataWrapList;
+  UINTN                         FreeRxDataWrapCount;
 } MNP_SERVICE_DATA;
 
 #define MNP_SERVICE_DATA_FROM_THIS(a) \
@@ -27,6 +27,7 @@ Abstract:
 #define NET_ETHER_FCS_SIZE            4
 
 #define MNP_SYS_POLL_INTERVAL         (50 * TICKS_PER_MS)   // 50 milliseconds
+#define MNP_SYS_POLL_INTERVAL_MIN     (10 * TICKS_PER_MS)   // 10 milliseconds
 #define MNP_TIMEOUT_CHECK_INTERVAL    (50 * TICKS_PER_MS)   // 50 milliseconds
 #define MNP_TX_TIMEOUT_TIME           (500 * TICKS_PER_MS)  // 500 milliseconds
 #define MNP_INIT_NET_BUFFER_NUM       512
@@ -35,6 +36,18 @@ Abstract:
 
 #define MNP_MAX_RCVD_PACKET_QUE_SIZE  256
 
+//
+// Maximum number of frames received by one poll, and maximum number of
+// transmits waiting for SNP to recycle their buffers.
+//
+#define MNP_RX_POLL_BUDGET            32
+#define MNP_MAX_TX_PENDING            32
+
+//
+// Maximum number of recycled MNP_RXDATA_WRAPs kept for reuse.
+//
+#define MNP_MAX_FREE_RXDATA_WRAP      64
+
 #define MNP_RECEIVE_UNICAST           0x01
 #define MNP_RECEIVE_BROADCAST         0x02
 
@@ -97,6 +110,21 @@ typedef struct _MNP_RXDATA_WRAP {
   UINT64                            TimeoutTick;
 } MNP_RXDATA_WRAP;
 
+//
+// A transmit handed to SNP. Packet is the buffer given to Snp->Transmit (),
+// either the caller's fragment or Buffer, and is matched against the buffers
+// recycled by Snp->GetStatus (). Token is NULL once the transmit is aborted or
+// has timed out; the entry is freed only when SNP gives the buffer back.
+//
+typedef struct _MNP_TX_ENTRY {
+  NET_LIST_ENTRY                        Entry;
+  MNP_INSTANCE_DATA                     *Instance;
+  EFI_MANAGED_NETWORK_COMPLETION_TOKEN  *Token;
+  UINT8                                 *Packet;
+  UINT64                                TimeoutTick;
+  UINT8                                 Buffer[1];
+} MNP_TX_ENTRY;
+
 EFI_STATUS
 MnpInitializeServiceData (
   IN MNP_SERVICE_DATA  *MnpServiceData,
@@ -158,18 +186,34 @@ VOID
 MnpBuildTxPacket (
   IN  MNP_SERVICE_DATA                   *MnpServiceData,
   IN  EFI_MANAGED_NETWORK_TRANSMIT_DATA  *TxData,
+  IN  UINT8                              *TxBuf,
   OUT UINT8                              **PktBuf,
   OUT UINT32                             *PktLen
   );
 
 EFI_STATUS
-MnpSyncSendPacket (
+MnpSendPacket (
   IN MNP_SERVICE_DATA                      *MnpServiceData,
-  IN UINT8                                 *Packet,
-  IN UINT32                                Length,
+  IN MNP_INSTANCE_DATA                     *Instance,
   IN EFI_MANAGED_NETWORK_COMPLETION_TOKEN  *Token
   );
 
+UINTN
+MnpRecycleTxBuf (
+  IN MNP_SERVICE_DATA  *MnpServiceData
+  );
+
+EFI_STATUS
+MnpCancelTxTokens (
+  IN MNP_INSTANCE_DATA                     *Instance,
+  IN EFI_MANAGED_NETWORK_COMPLETION_TOKEN  *Token OPTIONAL
+  );
+
+VOID
+MnpFlushTxQueue (
+  IN MNP_SERVICE_DATA  *MnpServiceData
+  );
+
 EFI_STATUS
 MnpInstanceDeliverPacket (
   IN MNP_INSTANCE_DATA  *Instance
@@ -187,6 +231,13 @@ MnpReceivePacket (
   IN MNP_SERVICE_DATA  *MnpServiceData
   );
 
+EFI_STATUS
+MnpReceivePackets (
+  IN  MNP_SERVICE_DATA  *MnpServiceData,
+  IN  UINTN             Budget,
+  OUT UINTN             *Received
+  );
+
 NET_BUF *
 MnpAllocNbuf (
   IN MNP_SERVICE_DATA  *MnpServiceData
@@ -120,6 +120,7 @@ VOID
 MnpBuildTxPacket (
   IN  MNP_SERVICE_DATA                   *MnpServiceData,
   IN  EFI_MANAGED_NETWORK_TRANSMIT_DATA  *TxData,
+  IN  UINT8                              *TxBuf,
   OUT UINT8                              **PktBuf,
   OUT UINT32                             *PktLen
   )
@@ -134,6 +135,8 @@ Arguments:
   MnpServiceData - Pointer to the mnp service context data.
   TxData         - Pointer to the transmit data containing the information to
                    build the packet.
+  TxBuf          - Pointer to the buffer used if the packet has to be copied,
+                   it's at least Mtu plus the media header size long.
   PktBuf         - Pointer to record the address of the packet.
   PktLen         - Pointer to a UINT32 variable used to record the packet's length.
 
@@ -161,7 +164,7 @@ Returns:
     // media header space if necessary.
     //
     SnpMode = MnpServiceData->Snp->Mode;
-    DstPos  = MnpServiceData->TxBuf;
+    DstPos  = TxBuf;
 
     *PktLen = 0;
     if (TxData->DestinationAddress != NULL) {
@@ -188,44 +191,184 @@ Returns:
     //
     // Set the buffer pointer and the buffer length.
     //
-    *PktBuf = MnpServiceData->TxBuf;
+    *PktBuf = TxBuf;
     *PktLen += TxData->DataLength + TxData->HeaderLength;
   }
 }
 
+STATIC
+MNP_TX_ENTRY *
+MnpAllocTxEntry (
+  IN MNP_SERVICE_DATA  *MnpServiceData
+  )
+/*++
+
+Routine Description:
+
+  Get a transmit entry, from the free list if possible.
+
+Arguments:
+
+  MnpServiceData - Pointer to the mnp service context data.
+
+Returns:
+
+  Pointer to the transmit entry, or NULL if out of memory.
+
+--*/
+{
+  MNP_TX_ENTRY  *TxEntry;
+
+  if (!NetListIsEmpty (&MnpServiceData->FreeTxEntryList)) {
+    TxEntry = NET_LIST_HEAD (&MnpServiceData->FreeTxEntryList, MNP_TX_ENTRY, Entry);
+    NetListRemoveEntry (&TxEntry->Entry);
+    return TxEntry;
+  }
+
+  return NetAllocatePool (
+           sizeof (MNP_TX_ENTRY) + MnpServiceData->Mtu + MnpServiceData->Snp->Mode->MediaHeaderSize
+           );
+}
+
+STATIC
+VOID
+MnpCompleteTxEntry (
+  IN MNP_SERVICE_DATA  *MnpServiceData,
+  IN MNP_TX_ENTRY      *TxEntry,
+  IN EFI_STATUS        Status
+  )
+/*++
+
+Routine Description:
+
+  Remove a transmit entry from the pending list, put it back to the free
+  list and signal its token, if it still has one, with Status.
+
+Arguments:
+
+  MnpServiceData - Pointer to the mnp service context data.
+  TxEntry        - Pointer to the transmit entry to complete.
+  Status         - The status to signal the token with.
+
+Returns:
+
+  None.
+
+--*/
+{
+  EFI_MANAGED_NETWORK_COMPLETION_TOKEN  *Token;
+
+  NetListRemoveEntry (&TxEntry->Entry);
+  MnpServiceData->TxPendingCount--;
+
+  Token = TxEntry->Token;
+  NetListInsertHead (&MnpServiceData->FreeTxEntryList, &TxEntry->Entry);
+
+  //
+  // The entry is off the pending list before the token is signaled, the
+  // notify function may transmit again.
+  //
+  if (Token != NULL) {
+    Token->Status = Status;
+    gBS->SignalEvent (Token->Event);
+  }
+}
+
+UINTN
+MnpRecycleTxBuf (
+  IN MNP_SERVICE_DATA  *MnpServiceData
+  )
+/*++
+
+Routine Description:
+
+  Collect the transmit buffers recycled by SNP and signal the tokens of the
+  transmits they belong to.
+
+Arguments:
+
+  MnpServiceData - Pointer to the mnp service context data.
+
+Returns:
+
+  The number of transmit tokens signaled.
+
+--*/
+{
+  EFI_STATUS                  Status;
+  EFI_SIMPLE_NETWORK_PROTOCOL *Snp;
+  NET_LIST_ENTRY              *Entry;
+  MNP_TX_ENTRY                *TxEntry;
+  UINT8                       *TxBuf;
+  UINTN                       Completed;
+
+  Snp       = MnpServiceData->Snp;
+  Completed = 0;
+
+  while (MnpServiceData->TxPendingCount != 0) {
+
+    TxBuf   = NULL;
+    Status  = Snp->GetStatus (Snp, NULL, (VOID **) &TxBuf);
+    if (EFI_ERROR (Status) || (TxBuf == NULL)) {
+      break;
+    }
+
+    //
+    // SNP recycles buffers in the order they are transmitted, so the match
+    // is normally the first entry. Entries whose token has timed out or been
+    // aborted are still on the list and are released here.
+    //
+    NET_LIST_FOR_EACH (Entry, &MnpServiceData->TxPendingList) {
+      TxEntry = NET_LIST_USER_STRUCT (Entry, MNP_TX_ENTRY, Entry);
+
+      if (TxEntry->Packet == TxBuf) {
+        if (TxEntry->Token != NULL) {
+          Completed++;
+        }
+
+        MnpCompleteTxEntry (MnpServiceData, TxEntry, EFI_SUCCESS);
+        break;
+      }
+    }
+  }
+
+  return Completed;
+}
+
 EFI_STATUS
-MnpSyncSendPacket (
+MnpSendPacket (
   IN MNP_SERVICE_DATA                      *MnpServiceData,
-  IN UINT8                                 *Packet,
-  IN UINT32                                Length,
+  IN MNP_INSTANCE_DATA                     *Instance,
   IN EFI_MANAGED_NETWORK_COMPLETION_TOKEN  *Token
   )
 /*++
 
 Routine Description:
 
-  Synchronously send out the packet.
+  Build the packet from the token and hand it to SNP. The token is signaled
+  once SNP recycles the transmit buffer, the transmit fails or it times out.
 
 Arguments:
 
   MnpServiceData - Pointer to the mnp service context data.
-  Packet         - Pointer to the pakcet buffer.
-  Length         - The length of the packet.
+  Instance       - Pointer to the mnp instance context data.
   Token          - Pointer to the token the packet generated from.
 
 Returns:
 
-  EFI_SUCCESS      - The packet is sent out.
-  EFI_TIMEOUT      - Time out occurs, the packet isn't sent.
-  EFI_DEVICE_ERROR - An unexpected network error occurs.
+  EFI_SUCCESS          - The packet is queued, or it failed and the token is
+                         signaled with EFI_TIMEOUT or EFI_DEVICE_ERROR.
+  EFI_OUT_OF_RESOURCES - No memory to track the transmit.
 
 --*/
 {
   EFI_STATUS                        Status;
   EFI_SIMPLE_NETWORK_PROTOCOL       *Snp;
   EFI_MANAGED_NETWORK_TRANSMIT_DATA *TxData;
+  MNP_TX_ENTRY                      *TxEntry;
   UINT32                            HeaderSize;
-  UINT8                             *TxBuf;
+  UINT32                            Length;
+  BOOLEAN                           TimerStarted;
 
   Snp         = MnpServiceData->Snp;
   TxData      = Token->Packet.TxData;
@@ -233,89 +376,195 @@ Returns:
   HeaderSize  = Snp->Mode->MediaHeaderSize - TxData->HeaderLength;
 
   //
-  // Start the timeout event.
+  // Collect the finished transmits first, it completes their tokens and
+  // makes room in the pending list.
   //
-  Status = gBS->SetTimer (
-                  MnpServiceData->TxTimeoutEvent,
-                  TimerRelative,
-                  MNP_TX_TIMEOUT_TIME
-                  );
-  if (EFI_ERROR (Status)) {
+  MnpRecycleTxBuf (MnpServiceData);
 
-    goto SIGNAL_TOKEN;
+  TxEntry = MnpAllocTxEntry (MnpServiceData);
+  if (TxEntry == NULL) {
+    return EFI_OUT_OF_RESOURCES;
   }
 
+  MnpBuildTxPacket (MnpServiceData, TxData, TxEntry->Buffer, &TxEntry->Packet, &Length);
+
+  TimerStarted = FALSE;
   for (;;) {
-    //
-    // Transmit the packet through SNP.
-    //
-    Status = Snp->Transmit (
-                    Snp,
-                    HeaderSize,
-                    Length,
-                    Packet,
-                    TxData->SourceAddress,
-                    TxData->DestinationAddress,
-                    &TxData->ProtocolType
-                    );
-    if ((Status != EFI_SUCCESS) && (Status != EFI_NOT_READY)) {
-
-      Status = EFI_DEVICE_ERROR;
-      break;
-    }
 
-    //
-    // If Status is EFI_SUCCESS, the packet is put in the transmit queue.
-    // if Status is EFI_NOT_READY, the transmit engine of the network interface is busy.
-    // Both need to sync SNP.
-    //
-    TxBuf = NULL;
-    do {
+    if (MnpServiceData->TxPendingCount < MNP_MAX_TX_PENDING) {
       //
-      // Get the recycled transmit buffer status.
+      // Transmit the packet through SNP.
       //
-      Snp->GetStatus (Snp, NULL, &TxBuf);
+      Status = Snp->Transmit (
+                      Snp,
+                      HeaderSize,
+                      Length,
+                      TxEntry->Packet,
+                      TxData->SourceAddress,
+                      TxData->DestinationAddress,
+                      &TxData->ProtocolType
+                      );
+      if (Status == EFI_SUCCESS) {
+        break;
+      }
 
-      if (!EFI_ERROR (gBS->CheckEvent (MnpServiceData->TxTimeoutEvent))) {
+      if (Status != EFI_NOT_READY) {
+        Status = EFI_DEVICE_ERROR;
+        break;
+      }
+    }
 
-        Status = EFI_TIMEOUT;
+    //
+    // Either too many transmits are pending or the transmit engine of the
+    // network interface is busy. Wait for SNP to recycle a buffer, at most
+    // MNP_TX_TIMEOUT_TIME. The timer is only started if we have to wait.
+    //
+    if (!TimerStarted) {
+      Status = gBS->SetTimer (
+                      MnpServiceData->TxTimeoutEvent,
+                      TimerRelative,
+                      MNP_TX_TIMEOUT_TIME
+                      );
+      if (EFI_ERROR (Status)) {
         break;
       }
-    } while (TxBuf == NULL);
 
-    if ((Status == EFI_SUCCESS) || (Status == EFI_TIMEOUT)) {
+      TimerStarted = TRUE;
+    } else if (!EFI_ERROR (gBS->CheckEvent (MnpServiceData->TxTimeoutEvent))) {
 
+      Status = EFI_TIMEOUT;
       break;
-    } else {
-      //
-      // Status is EFI_NOT_READY. Restart the timer event and call Snp->Transmit again.
-      //
-      gBS->SetTimer (
-            MnpServiceData->TxTimeoutEvent,
-            TimerRelative,
-            MNP_TX_TIMEOUT_TIME
-            );
     }
+
+    MnpRecycleTxBuf (MnpServiceData);
+  }
+
+  if (TimerStarted) {
+    gBS->SetTimer (MnpServiceData->TxTimeoutEvent, TimerCancel, 0);
+  }
+
+  if (Status == EFI_SUCCESS) {
+    //
+    // The packet is in the transmit queue of SNP, the token is signaled
+    // when SNP recycles the buffer.
+    //
+    TxEntry->Instance     = Instance;
+    TxEntry->Token        = Token;
+    TxEntry->TimeoutTick  = MNP_TX_TIMEOUT_TIME;
+    NetListInsertTail (&MnpServiceData->TxPendingList, &TxEntry->Entry);
+    MnpServiceData->TxPendingCount++;
+  } else {
+
+    NetListInsertHead (&MnpServiceData->FreeTxEntryList, &TxEntry->Entry);
+
+    Token->Status = Status;
+    gBS->SignalEvent (Token->Event);
   }
 
   //
-  // Cancel the timer event.
+  // Dispatch the DPC queued by the NotifyFunction of the signaled tokens.
   //
-  gBS->SetTimer (MnpServiceData->TxTimeoutEvent, TimerCancel, 0);
+  NetLibDispatchDpc ();
+
+  return EFI_SUCCESS;
+}
+
+EFI_STATUS
+MnpCancelTxTokens (
+  IN MNP_INSTANCE_DATA                     *Instance,
+  IN EFI_MANAGED_NETWORK_COMPLETION_TOKEN  *Token OPTIONAL
+  )
+/*++
+
+Routine Description:
+
+  Abort the pending transmits of the instance. The buffers stay with SNP,
+  the entries are released when SNP recycles them or the queue is flushed.
+
+Arguments:
+
+  Instance - Pointer to the mnp instance context data.
+  Token    - Pointer to the token to abort, all the instance's transmit tokens
+             are aborted if it's NULL.
 
-SIGNAL_TOKEN:
+Returns:
+
+  EFI_SUCCESS - The Token is NULL and the transmit tokens are aborted, or
+                the Token isn't a pending transmit token.
+  EFI_ABORTED - The Token isn't NULL and it's aborted.
 
-  Token->Status = Status;
-  gBS->SignalEvent (Token->Event);
+--*/
+{
+  MNP_SERVICE_DATA                      *MnpServiceData;
+  NET_LIST_ENTRY                        *Entry;
+  MNP_TX_ENTRY                          *TxEntry;
+  EFI_MANAGED_NETWORK_COMPLETION_TOKEN  *TokenToCancel;
+
+  MnpServiceData = Instance->MnpServiceData;
 
   //
-  // Dispatch the DPC queued by the NotifyFunction of Token->Event.
+  // The walk restarts after each token is signaled as the notify function
+  // may change the pending list.
   //
-  NetLibDispatchDpc ();
+  do {
+    TokenToCancel = NULL;
+
+    NET_LIST_FOR_EACH (Entry, &MnpServiceData->TxPendingList) {
+      TxEntry = NET_LIST_USER_STRUCT (Entry, MNP_TX_ENTRY, Entry);
+
+      if ((TxEntry->Token != NULL) && (TxEntry->Instance == Instance) &&
+          ((Token == NULL) || (TxEntry->Token == Token))) {
+
+        TokenToCancel   = TxEntry->Token;
+        TxEntry->Token  = NULL;
+        break;
+      }
+    }
+
+    if (TokenToCancel != NULL) {
+      TokenToCancel->Status = EFI_ABORTED;
+      gBS->SignalEvent (TokenToCancel->Event);
+
+      if (Token != NULL) {
+        return EFI_ABORTED;
+      }
+    }
+  } while (TokenToCancel != NULL);
 
   return EFI_SUCCESS;
 }
 
+VOID
+MnpFlushTxQueue (
+  IN MNP_SERVICE_DATA  *MnpServiceData
+  )
+/*++
+
+Routine Description:
+
+  Abort all the pending transmits, used before the simple network is
+  stopped as it won't recycle the buffers afterwards.
+
+Arguments:
+
+  MnpServiceData - Pointer to the mnp service context data.
+
+Returns:
+
+  None.
+
+--*/
+{
+  MNP_TX_ENTRY  *TxEntry;
+
+  while (!NetListIsEmpty (&MnpServiceData->TxPendingList)) {
+    TxEntry = NET_LIST_HEAD (&MnpServiceData->TxPendingList, MNP_TX_ENTRY, Entry);
+    MnpCompleteTxEntry (MnpServiceData, TxEntry, EFI_ABORTED);
+  }
+
+  ASSERT (MnpServiceData->TxPendingCount == 0);
+}
+
 EFI_STATUS
 MnpInstanceDeliverPacket (
   IN MNP_INSTANCE_DATA  *Instance
@@ -478,6 +727,7 @@ Returns:
 {
   MNP_RXDATA_WRAP   *RxDataWrap;
   MNP_SERVICE_DATA  *MnpServiceData;
+  EFI_TPL           OldTpl;
 
   ASSERT (Context != NULL);
 
@@ -496,16 +746,28 @@ Returns:
   RxDataWrap->Nbuf = NULL;
 
   //
-  // Close the recycle event.
+  // Remove this Wrap entry from the list.
   //
-  gBS->CloseEvent (RxDataWrap->RxData.RecycleEvent);
+  NetListRemoveEntry (&RxDataWrap->WrapEntry);
 
   //
-  // Remove this Wrap entry from the list.
+  // Keep the wrap and its recycle event for the next received packet,
+  // the free list is also used from the recycle event so lock it out.
   //
-  NetListRemoveEntry (&RxDataWrap->WrapEntry);
+  OldTpl = NET_RAISE_TPL (NET_TPL_RECYCLE);
+
+  if (MnpServiceData->FreeRxDataWrapCount < MNP_MAX_FREE_RXDATA_WRAP) {
+    NetListInsertHead (&MnpServiceData->FreeRxDataWrapList, &RxDataWrap->WrapEntry);
+    MnpServiceData->FreeRxDataWrapCount++;
+    RxDataWrap = NULL;
+  }
+
+  NET_RESTORE_TPL (OldTpl);
 
-  NetFreePool (RxDataWrap);
+  if (RxDataWrap != NULL) {
+    gBS->CloseEvent (RxDataWrap->RxData.RecycleEvent);
+    NetFreePool (RxDataWrap);
+  }
 }
 
 STATIC
@@ -788,8 +1050,37 @@ Returns:
 
 --*/
 {
-  EFI_STATUS      Status;
-  MNP_RXDATA_WRAP *RxDataWrap;
+  EFI_STATUS        Status;
+  MNP_RXDATA_WRAP   *RxDataWrap;
+  MNP_SERVICE_DATA  *MnpServiceData;
+  EFI_EVENT         RecycleEvent;
+  EFI_TPL           OldTpl;
+
+  MnpServiceData = Instance->MnpServiceData;
+
+  //
+  // Reuse a recycled wrap if there is one, its recycle event is still open
+  // and already bound to it.
+  //
+  RxDataWrap = NULL;
+  OldTpl     = NET_RAISE_TPL (NET_TPL_RECYCLE);
+
+  if (!NetListIsEmpty (&MnpServiceData->FreeRxDataWrapList)) {
+    RxDataWrap = NET_LIST_HEAD (&MnpServiceData->FreeRxDataWrapList, MNP_RXDATA_WRAP, WrapEntry);
+    NetListRemoveEntry (&RxDataWrap->WrapEntry);
+    MnpServiceData->FreeRxDataWrapCount--;
+  }
+
+  NET_RESTORE_TPL (OldTpl);
+
+  if (RxDataWrap != NULL) {
+    RecycleEvent                    = RxDataWrap->RxData.RecycleEvent;
+    RxDataWrap->Instance            = Instance;
+    RxDataWrap->RxData              = *RxData;
+    RxDataWrap->RxData.RecycleEvent = RecycleEvent;
+
+    return RxDataWrap;
+  }
 
   //
   // Allocate memory.
@@ -1066,6 +1357,58 @@ EXIT:
   return Status;
 }
 
+EFI_STATUS
+MnpReceivePackets (
+  IN  MNP_SERVICE_DATA  *MnpServiceData,
+  IN  UINTN             Budget,
+  OUT UINTN             *Received
+  )
+/*++
+
+Routine Description:
+
+  Receive and deliver packets until SNP has no more or Budget packets are
+  received.
+
+Arguments:
+
+  MnpServiceData - Pointer to the mnp service context data.
+  Budget         - The maximum number of packets to receive.
+  Received       - Pointer to the number of packets received.
+
+Returns:
+
+  EFI_SUCCESS      - At least one packet is received, or there is no child
+                     to receive packets for.
+  Other            - The status of MnpReceivePacket () if no packet is received.
+
+--*/
+{
+  EFI_STATUS  Status;
+
+  *Received = 0;
+
+  if (NetListIsEmpty (&MnpServiceData->ChildrenList)) {
+    //
+    // There is no child, no need to receive packets.
+    //
+    return EFI_SUCCESS;
+  }
+
+  Status = EFI_SUCCESS;
+  while (*Received < Budget) {
+
+    Status = MnpReceivePacket (MnpServiceData);
+    if (EFI_ERROR (Status)) {
+      break;
+    }
+
+    (*Received)++;
+  }
+
+  return (*Received != 0) ? EFI_SUCCESS : Status;
+}
+
 VOID
 EFIAPI
 MnpCheckPacketTimeout (
@@ -1089,17 +1432,62 @@ Returns:
 
 --*/
 {
-  MNP_SERVICE_DATA  *MnpServiceData;
-  NET_LIST_ENTRY    *Entry;
-  NET_LIST_ENTRY    *RxEntry;
-  NET_LIST_ENTRY    *NextEntry;
-  MNP_INSTANCE_DATA *Instance;
-  MNP_RXDATA_WRAP   *RxDataWrap;
-  EFI_TPL           OldTpl;
+  MNP_SERVICE_DATA                      *MnpServiceData;
+  NET_LIST_ENTRY                        *Entry;
+  NET_LIST_ENTRY                        *RxEntry;
+  NET_LIST_ENTRY                        *NextEntry;
+  MNP_INSTANCE_DATA                     *Instance;
+  MNP_RXDATA_WRAP                       *RxDataWrap;
+  MNP_TX_ENTRY                          *TxEntry;
+  MNP_TX_ENTRY                          *Expired;
+  EFI_TPL                               OldTpl;
+  EFI_MANAGED_NETWORK_COMPLETION_TOKEN  *Token;
 
   MnpServiceData = (MNP_SERVICE_DATA *) Context;
   NET_CHECK_SIGNATURE (MnpServiceData, MNP_SERVICE_DATA_SIGNATURE);
 
+  //
+  // Collect the finished transmits, age the rest and signal the tokens of
+  // the expired ones with EFI_TIMEOUT. SNP still owns the buffer of an
+  // expired transmit, so its entry stays on the pending list without a
+  // token until SNP recycles the buffer or the queue is flushed. The walk
+  // restarts after each token as its notify function may change the list.
+  //
+  MnpRecycleTxBuf (MnpServiceData);
+
+  NET_LIST_FOR_EACH (Entry, &MnpServiceData->TxPendingList) {
+    TxEntry = NET_LIST_USER_STRUCT (Entry, MNP_TX_ENTRY, Entry);
+
+    if (TxEntry->TimeoutTick >= MNP_TIMEOUT_CHECK_INTERVAL) {
+      TxEntry->TimeoutTick -= MNP_TIMEOUT_CHECK_INTERVAL;
+    } else {
+      TxEntry->TimeoutTick = 0;
+    }
+  }
+
+  do {
+    Expired = NULL;
+
+    NET_LIST_FOR_EACH (Entry, &MnpServiceData->TxPendingList) {
+      TxEntry = NET_LIST_USER_STRUCT (Entry, MNP_TX_ENTRY, Entry);
+
+      if ((TxEntry->Token != NULL) && (TxEntry->TimeoutTick == 0)) {
+        Expired = TxEntry;
+        break;
+      }
+    }
+
+    if (Expired != NULL) {
+      MNP_DEBUG_WARN (("MnpCheckPacketTimeout: Transmit timeout.\n"));
+
+      Token           = Expired->Token;
+      Expired->Token  = NULL;
+
+      Token->Status = EFI_TIMEOUT;
+      gBS->SignalEvent (Token->Event);
+    }
+  } while (Expired != NULL);
+
   NET_LIST_FOR_EACH (Entry, &MnpServiceData->ChildrenList) {
 
     Instance = NET_LIST_USER_STRUCT (Entry, MNP_INSTANCE_DATA, InstEntry);
@@ -1161,14 +1549,37 @@ Returns:
 --*/
 {
   MNP_SERVICE_DATA  *MnpServiceData;
+  UINTN             Received;
+  UINT64            Interval;
 
   MnpServiceData = (MNP_SERVICE_DATA *) Context;
   NET_CHECK_SIGNATURE (MnpServiceData, MNP_SERVICE_DATA_SIGNATURE);
 
   //
-  // Try to receive packets from Snp.
+  // Complete the finished transmits and receive the packets from Snp.
   //
-  MnpReceivePacket (MnpServiceData);
+  MnpRecycleTxBuf (MnpServiceData);
+  MnpReceivePackets (MnpServiceData, MNP_RX_POLL_BUDGET, &Received);
 
   NetLibDispatchDpc ();
+
+  //
+  // Poll at the shortest interval while packets are arriving, and back off
+  // to the default interval when the network goes quiet.
+  //
+  if (Received != 0) {
+    Interval = MNP_SYS_POLL_INTERVAL_MIN;
+  } else {
+    Interval = MnpServiceData->PollInterval + MnpServiceData->PollInterval;
+    if (Interval > MNP_SYS_POLL_INTERVAL) {
+      Interval = MNP_SYS_POLL_INTERVAL;
+    }
+  }
+
+  if (MnpServiceData->EnableSystemPoll && (Interval != MnpServiceData->PollInterval)) {
+
+    if (!EFI_ERROR (gBS->SetTimer (MnpServiceData->PollTimer, TimerPeriodic, Interval))) {
+      MnpServiceData->PollInterval = Interval;
+    }
+  }
 }
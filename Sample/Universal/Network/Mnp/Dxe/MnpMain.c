@@ -431,8 +431,6 @@ Returns:
   EFI_STATUS        Status;
   MNP_INSTANCE_DATA *Instance;
   MNP_SERVICE_DATA  *MnpServiceData;
-  UINT8             *PktBuf;
-  UINT32            PktLen;
   EFI_TPL           OldTpl;
 
   if ((This == NULL) || (Token == NULL)) {
@@ -462,14 +460,9 @@ Returns:
   NET_CHECK_SIGNATURE (MnpServiceData, MNP_SERVICE_DATA_SIGNATURE);
 
   //
-  // Build the tx packet
+  // Hand the packet to SNP, the token is signaled when SNP is done with it.
   //
-  MnpBuildTxPacket (MnpServiceData, Token->Packet.TxData, &PktBuf, &PktLen);
-
-  //
-  //  OK, send the packet synchronously.
-  //
-  Status = MnpSyncSendPacket (MnpServiceData, PktBuf, PktLen, Token);
+  Status = MnpSendPacket (MnpServiceData, Instance, Token);
 
 ON_EXIT:
   NET_RESTORE_TPL (OldTpl);
@@ -616,6 +609,13 @@ Returns:
   //
   Status = NetMapIterate (&Instance->RxTokenMap, MnpCancelTokens, (VOID *) Token);
 
+  if (Status != EFI_ABORTED) {
+    //
+    // Then the pending transmits.
+    //
+    Status = MnpCancelTxTokens (Instance, Token);
+  }
+
   if (Token != NULL) {
 
     Status = (Status == EFI_ABORTED) ? EFI_SUCCESS : EFI_NOT_FOUND;
@@ -661,6 +661,8 @@ Returns:
   EFI_STATUS         Status;
   MNP_INSTANCE_DATA  *Instance;
   EFI_TPL            OldTpl;
+  UINTN              Completed;
+  UINTN              Received;
 
   if (This == NULL) {
     return EFI_INVALID_PARAMETER;
@@ -676,9 +678,14 @@ Returns:
   }
 
   //
-  // Try to receive packets.
+  // Complete the finished transmits and try to receive packets.
   //
-  Status = MnpReceivePacket (Instance->MnpServiceData);
+  Completed = MnpRecycleTxBuf (Instance->MnpServiceData);
+  Status    = MnpReceivePackets (Instance->MnpServiceData, MNP_RX_POLL_BUDGET, &Received);
+
+  if ((Completed != 0) && (Status == EFI_NOT_READY)) {
+    Status = EFI_SUCCESS;
+  }
 
   NetLibDispatchDpc ();
 
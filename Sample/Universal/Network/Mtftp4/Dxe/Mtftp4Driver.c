@@ -419,6 +419,7 @@ Returns:
     Mtftp4CleanService (MtftpSb);
 
     NetFreePool (MtftpSb);
+    NetbufCacheFlush ();
   } else {
 
     while (!NetListIsEmpty (&MtftpSb->Children)) {
@@ -467,6 +468,7 @@ Returns:
   Instance->Service   = MtftpSb;
 
   NetListInit (&Instance->Blocks);
+  NetListInit (&Instance->Window);
 }
 
 EFI_STATUS
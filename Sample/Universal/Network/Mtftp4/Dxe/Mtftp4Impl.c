@@ -101,6 +101,7 @@ Returns:
   NET_LIST_ENTRY            *Next;
   MTFTP4_BLOCK_RANGE        *Block;
   EFI_MTFTP4_TOKEN          *Token;
+  NET_BUF                   *Packet;
 
   //
   // Free various resources.
@@ -136,12 +137,21 @@ Returns:
     NetFreePool (Block);
   }
 
+  NET_LIST_FOR_EACH_SAFE (Entry, Next, &Instance->Window) {
+    Packet = NET_LIST_USER_STRUCT (Entry, NET_BUF, List);
+    NetListRemoveEntry (Entry);
+    NetbufFree (Packet);
+  }
+
   NetZeroMem (&Instance->RequestOption, sizeof (MTFTP4_OPTION));
 
   Instance->Operation     = 0;
 
   Instance->BlkSize       = MTFTP4_DEFAULT_BLKSIZE;
   Instance->LastBlock     = 0;
+  Instance->WindowSize    = MTFTP4_DEFAULT_WINDOWSIZE;
+  Instance->AckedBlock    = 0;
+  Instance->DupAcked      = FALSE;
   Instance->ServerIp      = 0;
   Instance->ListeningPort = 0;
   Instance->ConnectedPort = 0;
@@ -753,6 +763,9 @@ Returns:
   Config                  = &Instance->Config;
   Instance->Token         = Token;
   Instance->BlkSize       = MTFTP4_DEFAULT_BLKSIZE;
+  Instance->WindowSize    = MTFTP4_DEFAULT_WINDOWSIZE;
+  Instance->AckedBlock    = 0;
+  Instance->DupAcked      = FALSE;
 
   NetCopyMem (&Instance->ServerIp, &Config->ServerIp, sizeof (IP4_ADDR));
   Instance->ServerIp      = NTOHL (Instance->ServerIp);
@@ -21,6 +21,7 @@ Abstract:
    RFC2347 - TFTP Option Extension
    RFC2348 - TFTP Blocksize Option
    RFC2349 - TFTP Timeout Interval and Transfer Size Options
+   RFC7440 - TFTP Windowsize Option
 
 --*/
 
@@ -44,6 +45,7 @@ enum {
   MTFTP4_DEFAULT_TIMEOUT     = 3,
   MTFTP4_DEFAULT_RETRY       = 5,
   MTFTP4_DEFAULT_BLKSIZE     = 512,
+  MTFTP4_DEFAULT_WINDOWSIZE  = 1,
   MTFTP4_TIME_TO_GETMAP      = 5,
 
   MTFTP4_STATE_UNCONFIGED    = 0,
@@ -101,6 +103,18 @@ typedef struct _MTFTP4_PROTOCOL {
   UINT16                        LastBlock;
   NET_LIST_ENTRY                Blocks;
 
+  //
+  // Sliding window negotiated by the windowsize option. The download
+  // only ACKs every WindowSize blocks, AckedBlock is the last block
+  // ACKed and DupAcked is set once an out of order block has been
+  // answered. The upload keeps its sent but unacknowledged DATA
+  // packets in Window for go-back-N retransmission.
+  //
+  UINT16                        WindowSize;
+  UINT16                        AckedBlock;
+  BOOLEAN                       DupAcked;
+  NET_LIST_ENTRY                Window;
+
   //
   // The server's communication end point: IP and two ports. one for
   // initial request, one for its selected port.
@@ -120,12 +120,15 @@ Returns:
   Ack->Ack.OpCode   = HTONS (EFI_MTFTP4_OPCODE_ACK);
   Ack->Ack.Block[0] = HTONS (BlkNo);
 
+  Instance->AckedBlock = BlkNo;
+
   return Mtftp4SendPacket (Instance, Packet);
 }
 
 EFI_STATUS
 Mtftp4RrqSaveBlock (
   IN MTFTP4_PROTOCOL        *Instance,
+  IN NET_BUF                *UdpPacket,
   IN EFI_MTFTP4_PACKET      *Packet,
   IN UINT32                 Len
   )
@@ -135,11 +138,15 @@ Routine Description:
 
   Deliver the received data block to the user, which can be saved 
   in the user provide buffer or through the CheckPacket callback.
+  The data is copied to the user's buffer directly from the received
+  NET_BUF, which may be a chain of IP fragments.
 
 Arguments:
 
   Instance  - The Mtftp session
-  Packet    - The received data packet
+  UdpPacket - The received UDP datagram
+  Packet    - The received data packet, only the header is valid if
+              there is no CheckPacket callback
   Len       - The packet length
 
 Returns:
@@ -199,7 +206,7 @@ Returns:
     Start = MultU64x32 (Block - 1, Instance->BlkSize);
 
     if (Start + DataLen <= Token->BufferSize) {
-      NetCopyMem ((UINT8 *) Token->Buffer + Start, Packet->Data.Data, DataLen);
+      NetbufCopy (UdpPacket, MTFTP4_DATA_HEAD_LEN, DataLen, (UINT8 *) Token->Buffer + Start);
 
       //
       // Update the file size when received the last block
@@ -232,6 +239,7 @@ Returns:
 EFI_STATUS
 Mtftp4RrqHandleData (
   IN  MTFTP4_PROTOCOL       *Instance,
+  IN  NET_BUF               *UdpPacket,
   IN  EFI_MTFTP4_PACKET     *Packet,
   IN  UINT32                Len,
   IN  BOOLEAN               Multicast,
@@ -242,11 +250,13 @@ Mtftp4RrqHandleData (
 Routine Description:
 
   Function to process the received data packets. It will save the block
-  then send back an ACK if it is active. 
+  then send back an ACK if it is active and the block completes the
+  current window. 
 
 Arguments:
 
   Instance  - The downloading MTFTP session
+  UdpPacket - The UDP datagram received
   Packet    - The packet received 
   Len       - The length of the packet
   Multicast - Whether this packet is multicast or unicast
@@ -271,34 +281,45 @@ Returns:
   ASSERT (Expected >= 0);
 
   //
-  // If we are active and received an unexpected packet, retransmit
-  // the last ACK then restart receiving. If we are passive, save 
-  // the block.
+  // If we are active and received an unexpected packet, either a
+  // block is lost or the server is resending because our ACK is lost.
+  // If no block has been received yet, retransmit the last packet
+  // (the request or the OACK's ACK). Otherwise ACK the last
+  // in-order block so the server restarts its window after it. With a
+  // window, do it only once until the download makes progress again,
+  // the rest of the server's window is out of order as well. If we
+  // are passive, save the block.
   //
   if (Instance->Master && (Expected != BlockNum)) {
-    Mtftp4Retransmit (Instance);
+    if (Expected == 1) {
+      Mtftp4Retransmit (Instance);
+    } else if ((Instance->WindowSize == 1) || !Instance->DupAcked) {
+      Instance->DupAcked = TRUE;
+      Mtftp4RrqSendAck (Instance, (UINT16) (Expected - 1));
+    }
+
     return EFI_SUCCESS;
   }
 
-  Status = Mtftp4RrqSaveBlock (Instance, Packet, Len);
+  Status = Mtftp4RrqSaveBlock (Instance, UdpPacket, Packet, Len);
 
   if (EFI_ERROR (Status)) {
     return Status;
   }
 
   //
-  // Reset the passive client's timer whenever it received a 
-  // valid data packet. 
+  // Reset the timer whenever a valid data packet is received. The 
+  // active client doesn't send an ACK for every block in a window.
   //
-  if (!Instance->Master) {
-    Mtftp4SetTimeout (Instance);
-  }
+  Instance->DupAcked = FALSE;
+  Mtftp4SetTimeout (Instance);
   
   //
   // Check whether we have received all the blocks. Send the ACK if we
-  // are active (unicast client or master client for multicast download).
-  // If we have received all the blocks, send an ACK even if we are passive
-  // to tell the server that we are done.
+  // are active (unicast client or master client for multicast download)
+  // and have received WindowSize blocks since the last ACK. If we have 
+  // received all the blocks, send an ACK even if we are passive to tell 
+  // the server that we are done.
   //
   Expected = Mtftp4GetNextBlockNum (&Instance->Blocks);
 
@@ -315,6 +336,10 @@ Returns:
       
     } else {
       BlockNum = (UINT16) (Expected - 1);
+
+      if ((UINT16) (BlockNum - Instance->AckedBlock) < Instance->WindowSize) {
+        return EFI_SUCCESS;
+      }
     }
     
     Mtftp4RrqSendAck (Instance, BlockNum);
@@ -339,6 +364,7 @@ Routine Description:
     2. The server can only use smaller blksize than that is requested
     3. The server can only use the same timeout as requested
     4. The server doesn't change its multicast channel.
+    5. The server can only use smaller windowsize than that is requested
     
 
 Arguments:
@@ -366,7 +392,8 @@ Returns:
   // return the timeout matches that requested.
   //
   if (((Reply->Exist & MTFTP4_BLKSIZE_EXIST) && (Reply->BlkSize > Request->BlkSize)) ||
-      ((Reply->Exist & MTFTP4_TIMEOUT_EXIST) && (Reply->Timeout != Request->Timeout))) {
+      ((Reply->Exist & MTFTP4_TIMEOUT_EXIST) && (Reply->Timeout != Request->Timeout)) ||
+      ((Reply->Exist & MTFTP4_WINDOWSIZE_EXIST) && (Reply->WindowSize > Request->WindowSize))) {
     return FALSE;
   }
 
@@ -597,6 +624,10 @@ Returns:
       if (Reply.Timeout != 0) {
         Instance->Timeout = Reply.Timeout;
       }  
+
+      if (Reply.WindowSize != 0) {
+        Instance->WindowSize = Reply.WindowSize;
+      }
     }    
     
   } else {
@@ -609,6 +640,10 @@ Returns:
     if (Reply.Timeout != 0) {
       Instance->Timeout = Reply.Timeout;
     }
+
+    if (Reply.WindowSize != 0) {
+      Instance->WindowSize = Reply.WindowSize;
+    }
   }
   
   //
@@ -646,6 +681,7 @@ Returns:
 {
   MTFTP4_PROTOCOL           *Instance;
   EFI_MTFTP4_PACKET         *Packet;
+  EFI_MTFTP4_PACKET         Head;
   BOOLEAN                   Completed;
   BOOLEAN                   Multicast;
   EFI_STATUS                Status;
@@ -692,10 +728,23 @@ Returns:
   
   //
   // Copy the MTFTP packet to a continuous buffer if it isn't already so.
+  // Large DATA packets arrive as a chain of IP fragments. Unless the user
+  // wants to check them, only copy their header. Mtftp4RrqSaveBlock will
+  // copy the data from the fragments to the user's buffer directly.
   //
   Len = UdpPacket->TotalSize;
 
   if (UdpPacket->BlockOpNum > 1) {
+    NetbufCopy (UdpPacket, 0, MTFTP4_DATA_HEAD_LEN, (UINT8 *) &Head);
+    Packet = &Head;
+  } else {
+    Packet = (EFI_MTFTP4_PACKET *) NetbufGetByte (UdpPacket, 0, NULL);
+  }
+
+  Opcode = NTOHS (Packet->OpCode);
+
+  if ((Packet == &Head) && 
+      ((Opcode != EFI_MTFTP4_OPCODE_DATA) || (Instance->Token->CheckPacket != NULL))) {
     Packet = NetAllocatePool (Len);
 
     if (Packet == NULL) {
@@ -704,13 +753,8 @@ Returns:
     }
 
     NetbufCopy (UdpPacket, 0, Len, (UINT8 *) Packet);
-
-  } else {
-    Packet = (EFI_MTFTP4_PACKET *) NetbufGetByte (UdpPacket, 0, NULL);
   }
 
-  Opcode = NTOHS (Packet->OpCode);
-
   //
   // Call the user's CheckPacket if provided. Abort the transmission
   // if CheckPacket returns an EFI_ERROR code.
@@ -749,7 +793,7 @@ Returns:
       goto ON_EXIT;
     }
 
-    Status = Mtftp4RrqHandleData (Instance, Packet, Len, Multicast, &Completed);
+    Status = Mtftp4RrqHandleData (Instance, UdpPacket, Packet, Len, Multicast, &Completed);
     break;
 
   case EFI_MTFTP4_OPCODE_OACK:
@@ -771,7 +815,7 @@ ON_EXIT:
   // Free the resources, then if !EFI_ERROR (Status), restart the
   // receive, otherwise end the session.
   //
-  if ((Packet != NULL) && (UdpPacket->BlockOpNum > 1)) {
+  if ((Packet != NULL) && (Packet != &Head) && (UdpPacket->BlockOpNum > 1)) {
     NetFreePool (Packet);
   }
 
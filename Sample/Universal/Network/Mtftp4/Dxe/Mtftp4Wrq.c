@@ -85,7 +85,8 @@ Mtftp4WrqSendBlock (
 
 Routine Description:
 
-  Build then send a MTFTP data packet for the MTFTP upload session.
+  Build then send a MTFTP data packet for the MTFTP upload session. The
+  packet is kept on the session's window until it is acknowledged.
 
 Arguments:
 
@@ -176,9 +177,114 @@ Returns:
     }  
   }
 
+  NET_GET_REF (UdpPacket);
+  NetListInsertTail (&Instance->Window, &UdpPacket->List);
+
   return Mtftp4SendPacket (Instance, UdpPacket);
 }
 
+STATIC
+INTN
+Mtftp4WrqLastSent (
+  IN MTFTP4_PROTOCOL        *Instance
+  )
+/*++
+
+Routine Description:
+
+  Get the number of the last block sent but not acknowledged.
+
+Arguments:
+
+  Instance  - The MTFTP upload session
+
+Returns:
+
+  -1 if the window is empty, otherwise the last block number sent.
+
+--*/
+{
+  EFI_MTFTP4_PACKET         *Packet;
+  NET_BUF                   *Nbuf;
+
+  if (NetListIsEmpty (&Instance->Window)) {
+    return -1;
+  }
+
+  Nbuf   = NET_LIST_TAIL (&Instance->Window, NET_BUF, List);
+  Packet = (EFI_MTFTP4_PACKET *) NetbufGetByte (Nbuf, 0, NULL);
+
+  return NTOHS (Packet->Data.Block);
+}
+
+STATIC
+EFI_STATUS
+Mtftp4WrqSendWindow (
+  IN MTFTP4_PROTOCOL        *Instance
+  )
+/*++
+
+Routine Description:
+
+  Fill the upload window. The blocks left on the window after an ACK 
+  haven't been received by the server, it restarts after the ACKed 
+  block, so resend them first. Then send new blocks until there are 
+  WindowSize blocks outstanding or the last block is sent.
+
+Arguments:
+
+  Instance  - The MTFTP upload session
+
+Returns:
+
+  EFI_SUCCESS - The window is sent.
+  Others      - Failed to build or send a data packet.
+
+--*/
+{
+  NET_LIST_ENTRY            *Entry;
+  NET_BUF                   *Packet;
+  EFI_STATUS                Status;
+  INTN                      Next;
+  UINTN                     Count;
+
+  Count = 0;
+
+  NET_LIST_FOR_EACH (Entry, &Instance->Window) {
+    Packet = NET_LIST_USER_STRUCT (Entry, NET_BUF, List);
+
+    NET_GET_REF (Packet);
+    Status = Mtftp4SendPacket (Instance, Packet);
+
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+
+    Count++;
+  }
+
+  if (Count == 0) {
+    Next = Mtftp4GetNextBlockNum (&Instance->Blocks);
+  } else {
+    Next = Mtftp4WrqLastSent (Instance) + 1;
+  }
+
+  while ((Count < Instance->WindowSize) && (Next <= 0xffff) &&
+         ((Instance->LastBlock == 0) || (Next <= Instance->LastBlock))) {
+
+    Status = Mtftp4WrqSendBlock (Instance, (UINT16) Next);
+
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+
+    Count++;
+    Next++;
+  }
+
+  return EFI_SUCCESS;
+}
+
 EFI_STATUS
 Mtftp4WrqHandleAck (
   IN  MTFTP4_PROTOCOL       *Instance,
@@ -190,9 +296,10 @@ Mtftp4WrqHandleAck (
 
 Routine Description:
 
-  Function to handle received ACK packet. If the ACK number matches the
-  expected block number, and there are more data pending, send the next
-  block. Otherwise tell the caller that we are done.
+  Function to handle received ACK packet. If the ACK number falls in
+  the window of the blocks sent, remove the acknowledged blocks, and if
+  there are more data pending, send the next window. Otherwise tell the 
+  caller that we are done.
 
 Arguments:
 
@@ -209,29 +316,46 @@ Returns:
 
 --*/
 {
+  NET_BUF                   *Acked;
   UINT16                    AckNum;
   INTN                      Expected;
+  INTN                      Last;
 
   *Completed  = FALSE;
   AckNum      = NTOHS (Packet->Ack.Block[0]);
   Expected    = Mtftp4GetNextBlockNum (&Instance->Blocks);
+  Last        = Mtftp4WrqLastSent (Instance);
 
   ASSERT (Expected >= 0);
 
+  if (Last < Expected) {
+    Last = Expected;
+  }
+
   //
   // Get an unwanted ACK, return EFI_SUCCESS to let Mtftp4WrqInput 
   // restart receive.
   //
-  if (Expected != AckNum) {
+  if ((AckNum < Expected) || (AckNum > Last)) {
     return EFI_SUCCESS;
   }
   
   //
-  // Remove the acked block number, if this is the last block number,
-  // tell the Mtftp4WrqInput to finish the transfer. This is the last
-  // block number if the block range are empty..
+  // Remove the acked block numbers and release their packets. If the 
+  // last block number is acked, tell the Mtftp4WrqInput to finish the 
+  // transfer. This is the last block number if the block range are empty.
   //
-  Mtftp4RemoveBlockNum (&Instance->Blocks, AckNum);
+  while (Expected <= AckNum) {
+    Mtftp4RemoveBlockNum (&Instance->Blocks, (UINT16) Expected);
+
+    if ((Expected != 0) && !NetListIsEmpty (&Instance->Window)) {
+      Acked = NET_LIST_HEAD (&Instance->Window, NET_BUF, List);
+      NetListRemoveEntry (&Acked->List);
+      NetbufFree (Acked);
+    }
+
+    Expected++;
+  }
 
   Expected = Mtftp4GetNextBlockNum (&Instance->Blocks);
 
@@ -257,7 +381,7 @@ Returns:
     }
   }
 
-  return Mtftp4WrqSendBlock (Instance, (UINT16) Expected);
+  return Mtftp4WrqSendWindow (Instance);
 }
 
 BOOLEAN
@@ -274,7 +398,8 @@ Routine Description:
     1. It only include options requested by us
     2. It can only include a smaller block size
     3. It can't change the proposed time out value.
-    4. Other requirements of the individal MTFTP options as required.s
+    4. It can only include a smaller window size
+    5. Other requirements of the individal MTFTP options as required.s
 
 Arguments:
 
@@ -299,7 +424,8 @@ Returns:
   // return the timeout matches that requested.
   //
   if (((Reply->Exist & MTFTP4_BLKSIZE_EXIST) && (Reply->BlkSize > Request->BlkSize)) ||
-      ((Reply->Exist & MTFTP4_TIMEOUT_EXIST) && (Reply->Timeout != Request->Timeout))) {
+      ((Reply->Exist & MTFTP4_TIMEOUT_EXIST) && (Reply->Timeout != Request->Timeout)) ||
+      ((Reply->Exist & MTFTP4_WINDOWSIZE_EXIST) && (Reply->WindowSize > Request->WindowSize))) {
     return FALSE;
   }
 
@@ -379,6 +505,10 @@ Returns:
   if (Reply.Timeout != 0) {
     Instance->Timeout = Reply.Timeout;
   }
+
+  if (Reply.WindowSize != 0) {
+    Instance->WindowSize = Reply.WindowSize;
+  }
   
   //
   // Build a bogus ACK0 packet then pass it to the Mtftp4WrqHandleAck,
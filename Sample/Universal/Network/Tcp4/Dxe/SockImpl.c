@@ -41,6 +41,32 @@ SockFreeFoo (
   return ;
 }
 
+STATIC
+VOID
+SockSndDataFree (
+  IN VOID *Arg
+  )
+/*++
+
+Routine Description:
+
+  Called when all the references to the data of a zero-copy
+  send token are released, signal the token to return the
+  buffer to the application. The status is set before.
+
+Arguments:
+
+  Arg - Pointer to the application's token.
+
+Returns:
+
+  None.
+
+--*/
+{
+  gBS->SignalEvent (((SOCK_COMPLETION_TOKEN *) Arg)->Event);
+}
+
 STATIC
 UINT32
 SockTcpDataToRcv (
@@ -242,8 +268,9 @@ Returns:
 
 EFI_STATUS
 SockProcessTcpSndData (
-  IN SOCKET   *Sock,
-  IN VOID     *TcpTxData
+  IN SOCKET     *Sock,
+  IN VOID       *TcpTxData,
+  IN SOCK_TOKEN *SockToken
   )
 /*++
 
@@ -256,6 +283,7 @@ Arguments:
 
   Sock      - Pointer to the socket.
   TcpTxData - Pointer to the tcp txdata.
+  SockToken - Pointer to the token that wraps the tcp txdata.
 
 Returns:
 
@@ -267,9 +295,24 @@ Returns:
   NET_BUF                 *SndData;
   EFI_STATUS              Status;
   EFI_TCP4_TRANSMIT_DATA  *TxData;
+  NET_VECTOR_EXT_FREE     ExtFree;
+  VOID                    *Arg;
 
   TxData = (EFI_TCP4_TRANSMIT_DATA *) TcpTxData;
 
+  //
+  // Large data is sent in place. The token is signaled
+  // when the last reference to the data is released
+  // instead of when the data is copied out.
+  //
+  ExtFree = (NET_VECTOR_EXT_FREE) SockFreeFoo;
+  Arg     = NULL;
+
+  if (TxData->DataLength >= SOCK_ZERO_COPY_MIN_SIZE) {
+    ExtFree = SockSndDataFree;
+    Arg     = SockToken->Token;
+  }
+
   //
   // transform this TxData into a NET_BUFFER
   // and insert it into Sock->SndBuffer
@@ -279,8 +322,8 @@ Returns:
               TxData->FragmentCount,
               0,
               0,
-              SockFreeFoo,
-              NULL
+              ExtFree,
+              Arg
               );
 
   if (NULL == SndData) {
@@ -290,6 +333,11 @@ Returns:
     return EFI_OUT_OF_RESOURCES;
   }
 
+  if (Arg != NULL) {
+    SockToken->ZeroCopy         = TRUE;
+    SockToken->Token->Status    = EFI_SUCCESS;
+  }
+
   NetbufQueAppend (Sock->SndBuffer.DataQueue, SndData);
 
   //
@@ -571,7 +619,7 @@ Returns:
     TxData    = SndToken->Packet.TxData;
 
     DataLen = TxData->DataLength;
-    Status  = SockProcessTcpSndData (Sock, TxData);
+    Status  = SockProcessTcpSndData (Sock, TxData, SockToken);
 
     if (EFI_ERROR (Status)) {
       goto OnError;
@@ -886,7 +934,10 @@ Returns:
 
 --*/
 {
-  SOCKET  *Child;
+  SOCKET          *Child;
+  NET_LIST_ENTRY  *Entry;
+  NET_LIST_ENTRY  *Next;
+  SOCK_TOKEN      *SockToken;
 
   ASSERT (Sock);
 
@@ -895,6 +946,21 @@ Returns:
   //
   Sock->Flag = 0;
 
+  //
+  // The zero-copy send tokens are signaled when their data
+  // is released by the flush below, record the error only.
+  //
+  NET_LIST_FOR_EACH_SAFE (Entry, Next, &Sock->ProcessingSndTokenList) {
+    SockToken = NET_LIST_USER_STRUCT (Entry, SOCK_TOKEN, TokenList);
+
+    if (SockToken->ZeroCopy) {
+      SockToken->Token->Status = Sock->SockError;
+
+      NetListRemoveEntry (Entry);
+      NetFreePool (SockToken);
+    }
+  }
+
   //
   // Flush the SndBuffer and RcvBuffer of Sock
   //
@@ -1138,8 +1204,15 @@ Returns:
 
     if (SockToken->RemainDataLen <= Count) {
 
+      //
+      // The zero-copy token is signaled when its data
+      // is released by the low layer protocol.
+      //
       NetListRemoveEntry (&(SockToken->TokenList));
-      SIGNAL_TOKEN (SndToken, EFI_SUCCESS);
+      if (!SockToken->ZeroCopy) {
+        SIGNAL_TOKEN (SndToken, EFI_SUCCESS);
+      }
+
       Count -= SockToken->RemainDataLen;
       NetFreePool (SockToken);
     } else {
@@ -1195,6 +1268,51 @@ Returns:
           );
 }
 
+NET_BUF *
+SockGetDataRef (
+  IN SOCKET *Sock,
+  IN UINT32 Len,
+  IN UINT32 HeadSpace
+  )
+/*++
+
+Routine Description:
+
+  Called by the low layer protocol to get a buffer that references,
+  instead of copies, at most Len bytes of data at the head of the
+  socket send buffer. Only the data of the zero-copy send tokens is
+  referenced, and the returned buffer doesn't cross the boundary of
+  the tokens.
+
+Arguments:
+
+  Sock      - Pointer to the socket.
+  Len       - The maximum length of the data to reference.
+  HeadSpace - The head space to reserve for the protocol headers.
+
+Returns:
+
+  Pointer to the buffer, or NULL if the data must be copied.
+
+--*/
+{
+  NET_BUF *Head;
+
+  ASSERT (Sock && SOCK_STREAM == Sock->Type);
+
+  if ((Len == 0) || (Sock->SndBuffer.DataQueue->BufNum == 0)) {
+    return NULL;
+  }
+
+  Head = NET_LIST_HEAD (&Sock->SndBuffer.DataQueue->BufList, NET_BUF, List);
+
+  if (Head->Vector->Free != SockSndDataFree) {
+    return NULL;
+  }
+
+  return NetbufGetFragment (Head, 0, NET_MIN (Len, Head->TotalSize), HeadSpace);
+}
+
 VOID
 SockDataRcvd (
   IN SOCKET    *Sock,
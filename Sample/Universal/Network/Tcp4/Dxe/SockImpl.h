@@ -48,8 +48,9 @@ SockFreeFoo (
 
 EFI_STATUS
 SockProcessTcpSndData (
-  IN SOCKET *Sock,
-  IN VOID   *TcpTxData
+  IN SOCKET     *Sock,
+  IN VOID       *TcpTxData,
+  IN SOCK_TOKEN *SockToken
   );
 
 VOID
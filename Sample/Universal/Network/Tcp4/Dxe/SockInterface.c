@@ -147,6 +147,7 @@ Returns:
   SockToken->Sock           = Sock;
   SockToken->Token          = (SOCK_COMPLETION_TOKEN *) Token;
   SockToken->RemainDataLen  = DataLen;
+  SockToken->ZeroCopy       = FALSE;
   NetListInsertTail (List, &SockToken->TokenList);
 
   return SockToken;
@@ -638,7 +639,7 @@ Returns:
       goto Exit;
     }
 
-    Status = SockProcessTcpSndData (Sock, TxData);
+    Status = SockProcessTcpSndData (Sock, TxData, SockToken);
 
     if (EFI_ERROR (Status)) {
       SOCK_DEBUG_ERROR (("SockSend: Failed to process "
@@ -37,6 +37,13 @@ Abstract:
 
 #define PROTO_RESERVED_LEN  20
 
+//
+// The data of the send tokens at least this long is sent from the
+// application's buffer in place, and the token is signaled when the
+// low layer protocol releases the data, that is, it has been ACKed.
+//
+#define SOCK_ZERO_COPY_MIN_SIZE 0x10000
+
 #define SO_NO_MORE_DATA     0x0001
 
 //
@@ -251,6 +258,17 @@ SockGetDataToSend (
   IN UINT8  *Dest
   );
 
+//
+// called by low layer protocol to get a buffer that references
+// the data at the head of the socket send buffer without copy
+//
+NET_BUF *
+SockGetDataRef (
+  IN SOCKET *Sock,
+  IN UINT32 Len,
+  IN UINT32 HeadSpace
+  );
+
 //
 //  called by low layer protocol to notify socket no more data can be
 //  received
@@ -401,6 +419,7 @@ typedef struct _SOCK_TOKEN {
   NET_LIST_ENTRY        TokenList;      // the entry to add in the token list
   SOCK_COMPLETION_TOKEN *Token;         // The application's token
   UINT32                RemainDataLen;  // unprocessed data length
+  BOOLEAN               ZeroCopy;       // the data is sent in place
   SOCKET                *Sock;          // the poninter to the socket this token
                                         // belongs to
 } SOCK_TOKEN;
@@ -149,7 +149,7 @@ Returns:
       Option->EnableTimeStamp     = !TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_NO_TS);
       Option->EnableWindowScaling = !TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_NO_WS);
 
-      Option->EnableSelectiveAck     = FALSE;
+      Option->EnableSelectiveAck     = !TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_NO_SACK);
       Option->EnablePathMtuDiscovery = FALSE;
     }
   }
@@ -264,6 +264,7 @@ Returns:
 
   if (SOCK_IS_CONFIGURED (Sock)) {
     NetListRemoveEntry (&Tcb->List);
+    NetListRemoveEntry (&Tcb->HashList);
 
     //
     // Uninstall the device path protocl.
@@ -315,6 +316,7 @@ Tcp4AttachPcb (
   }
 
   NetListInit (&Tcb->List);
+  NetListInit (&Tcb->HashList);
   NetListInit (&Tcb->SndQue);
   NetListInit (&Tcb->RcvQue);
 
@@ -568,6 +570,10 @@ Returns:
     if (Option->EnableWindowScaling == FALSE) {
       TCP_SET_FLG (Tcb->CtrlFlag, TCP_CTRL_NO_WS);
     }
+
+    if (Option->EnableSelectiveAck == FALSE) {
+      TCP_SET_FLG (Tcb->CtrlFlag, TCP_CTRL_NO_SACK);
+    }
   }
 
   //
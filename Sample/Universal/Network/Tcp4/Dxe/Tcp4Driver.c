@@ -215,6 +215,8 @@ Returns:
   mTcp4RandomPort = TCP4_PORT_KNOWN +
                     (UINT16) (NET_RANDOM(Seed) % TCP4_PORT_KNOWN);
 
+  TcpInitHash ();
+
   return Status;
 }
 
@@ -497,6 +499,7 @@ Returns:
     // Release the TCP service data
     //
     NetFreePool (TcpServiceData);
+    NetbufCacheFlush ();
   } else {
 
     while (!NetListIsEmpty (&TcpServiceData->SocketList)) {
@@ -144,6 +144,11 @@ TcpRetransmit (
   IN TCP_SEQNO Seq
   );
 
+INTN
+TcpSackRetransmit (
+  IN TCP_CB *Tcb
+  );
+
 UINT32
 TcpDataToSend (
   IN TCP_CB *Tcb,
@@ -228,6 +233,17 @@ TcpComputeRtt (
   IN UINT32 Measure
   );
 
+VOID
+TcpCubicOnLoss (
+  IN TCP_CB *Tcb,
+  IN UINT32 FlightSize
+  );
+
+VOID
+TcpSackClear (
+  IN TCP_CB *Tcb
+  );
+
 INTN
 TcpTrimInWnd (
   IN TCP_CB  *Tcb,
@@ -249,6 +265,11 @@ TcpAdjustSndQue (
 //
 // Functions from Tcp4Misc.c
 //
+VOID
+TcpInitHash (
+  VOID
+  );
+
 UINT16
 TcpChecksum (
   IN NET_BUF *Buf,
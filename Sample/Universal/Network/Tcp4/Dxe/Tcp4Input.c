@@ -48,6 +48,282 @@ Returns:
           TCP_SEQ_LEQ (Seg->Seq, Tcb->RcvWl2 + Tcb->RcvWnd));
 }
 
+STATIC
+UINT32
+TcpCubicRoot (
+  IN UINT32 Value
+  )
+/*++
+
+Routine Description:
+
+  Compute the integer cube root of Value.
+
+Arguments:
+
+  Value - The value to compute the cube root of.
+
+Returns:
+
+  The largest integer whose cube isn't greater than Value.
+
+--*/
+{
+  UINT32  Root;
+  UINT32  Trial;
+  INTN    Shift;
+
+  Root = 0;
+
+  for (Shift = 30; Shift >= 0; Shift -= 3) {
+    Root  = 2 * Root;
+    Trial = 3 * Root * (Root + 1) + 1;
+
+    if ((Value >> Shift) >= Trial) {
+      Value -= Trial << Shift;
+      Root++;
+    }
+  }
+
+  return Root;
+}
+
+VOID
+TcpCubicOnLoss (
+  IN TCP_CB *Tcb,
+  IN UINT32 FlightSize
+  )
+/*++
+
+Routine Description:
+
+  Reduce the slow start threshold on loss, and remember the
+  window the loss happened at for CUBIC to grow back to.
+
+Arguments:
+
+  Tcb        - Pointer to the TCP_CB of this TCP instance.
+  FlightSize - The amount of data sent but not yet ACKed.
+
+Returns:
+
+  None.
+
+--*/
+{
+  //
+  // Fast convergence: if the window didn't reach the last
+  // Wmax, release some bandwidth to the newer flows.
+  //
+  if (Tcb->CWnd < Tcb->CubicWMax) {
+    Tcb->CubicWMax = Tcb->CWnd / TCP_CUBIC_CONV_DEN * TCP_CUBIC_CONV_NUM;
+  } else {
+    Tcb->CubicWMax = Tcb->CWnd;
+  }
+
+  Tcb->CubicOrigin  = 0;
+  Tcb->Ssthresh     = NET_MAX (
+                        FlightSize / TCP_CUBIC_BETA_DEN * TCP_CUBIC_BETA_NUM,
+                        (UINT32) (2 * Tcb->SndMss)
+                        );
+}
+
+STATIC
+VOID
+TcpCubicCongestAvoid (
+  IN TCP_CB *Tcb
+  )
+/*++
+
+Routine Description:
+
+  CUBIC congestion avoidance, grow the congestion window towards
+  the value of the cubic function one RTT later.
+
+Arguments:
+
+  Tcb - Pointer to the TCP_CB of this TCP instance.
+
+Returns:
+
+  None.
+
+--*/
+{
+  UINT32  Mss;
+  UINT32  Segs;
+  UINT32  Elapsed;
+  UINT32  Delta;
+  UINT32  Target;
+  UINT32  Limit;
+  UINT32  Inc;
+  UINT64  Offset;
+
+  Mss   = Tcb->SndMss;
+  Limit = TCP_MAX_WIN << Tcb->SndWndScale;
+
+  if (Tcb->CubicOrigin == 0) {
+    //
+    // Start a new epoch. K is the time for the cubic to grow
+    // back to Wmax, K^3 = (Wmax - CWnd) / (C * Mss). Keep K^3
+    // in 32 bits.
+    //
+    Tcb->CubicEpoch = mTcpTick;
+
+    if (Tcb->CWnd < Tcb->CubicWMax) {
+      Segs              = NET_MIN ((Tcb->CubicWMax - Tcb->CWnd) / Mss, 0x300000);
+      Tcb->CubicK       = TcpCubicRoot (Segs * TCP_CUBIC_C_DEN / TCP_CUBIC_C_NUM);
+      Tcb->CubicOrigin  = Tcb->CubicWMax;
+    } else {
+      Tcb->CubicK       = 0;
+      Tcb->CubicOrigin  = Tcb->CWnd;
+    }
+  }
+
+  Elapsed = TCP_SUB_TIME (mTcpTick, Tcb->CubicEpoch) + (Tcb->SRtt >> TCP_RTT_SHIFT);
+
+  if (Elapsed < Tcb->CubicK) {
+    Delta = Tcb->CubicK - Elapsed;
+  } else {
+    Delta = Elapsed - Tcb->CubicK;
+  }
+
+  Delta   = NET_MIN (Delta, TCP_CUBIC_MAX_TIME);
+  Offset  = MultU64x32 (MultU64x32 (Delta * Delta, Delta), TCP_CUBIC_C_NUM * Mss);
+  Offset  = DivU64x32 (Offset, TCP_CUBIC_C_DEN, NULL);
+
+  if (Elapsed < Tcb->CubicK) {
+    Target = Mss;
+    if (Offset < Tcb->CubicOrigin) {
+      Target = Tcb->CubicOrigin - (UINT32) Offset;
+    }
+  } else {
+    Target = Limit;
+    if (Offset < Limit) {
+      Target = Tcb->CubicOrigin + (UINT32) Offset;
+    }
+  }
+
+  //
+  // Each ACK closes 1/CWnd of the distance to the target, so the
+  // distance is covered in about one RTT. Growth is capped at half
+  // a segment per ACK. Above the target, probe by 1% of a segment
+  // per RTT.
+  //
+  Segs = NET_MAX (Tcb->CWnd / Mss, 1);
+
+  if (Target > Tcb->CWnd) {
+    Inc = NET_MIN ((Target - Tcb->CWnd) / Segs, Mss / 2);
+  } else {
+    Inc = Mss / (100 * Segs);
+  }
+
+  //
+  // Don't grow slower than Reno with the same decrease
+  // factor, which is about half a segment every RTT.
+  //
+  Inc = NET_MAX (Inc, Mss * Mss / Tcb->CWnd / 2);
+
+  Tcb->CWnd += NET_MAX (Inc, 1);
+}
+
+STATIC
+VOID
+TcpSackUpdate (
+  IN TCP_CB     *Tcb,
+  IN TCP_OPTION *Option
+  )
+/*++
+
+Routine Description:
+
+  Mark the segments on the SndQue covered by the SACK blocks
+  of the received segment.
+
+Arguments:
+
+  Tcb    - Pointer to the TCP_CB of this TCP instance.
+  Option - Pointer to the options of the received segment.
+
+Returns:
+
+  None.
+
+--*/
+{
+  NET_LIST_ENTRY  *Entry;
+  TCP_SACK_BLOCK  *Block;
+  TCP_SEG         *Seg;
+  TCP_SEQNO       MaxSndNxt;
+  UINT8           Index;
+
+  MaxSndNxt = TcpGetMaxSndNxt (Tcb);
+
+  for (Index = 0; Index < Option->SackNum; Index++) {
+    Block = &Option->Sack[Index];
+
+    //
+    // Ignore the blocks below SND.UNA, such as D-SACK,
+    // and the blocks for data never sent.
+    //
+    if (TCP_SEQ_LEQ (Block->Right, Block->Left) ||
+        TCP_SEQ_LEQ (Block->Right, Tcb->SndUna) ||
+        TCP_SEQ_GT (Block->Right, MaxSndNxt)) {
+
+      continue;
+    }
+
+    NET_LIST_FOR_EACH (Entry, &Tcb->SndQue) {
+      Seg = TCPSEG_NETBUF (NET_LIST_USER_STRUCT (Entry, NET_BUF, List));
+
+      if (TCP_SEQ_GEQ (Seg->Seq, Block->Right)) {
+        break;
+      }
+
+      if (TCP_SEQ_GEQ (Seg->Seq, Block->Left) &&
+          TCP_SEQ_LEQ (Seg->End, Block->Right)) {
+
+        Seg->Sacked = TRUE;
+      }
+    }
+
+    if (TCP_SEQ_GT (Block->Right, Tcb->SackHigh)) {
+      Tcb->SackHigh = Block->Right;
+    }
+  }
+}
+
+VOID
+TcpSackClear (
+  IN TCP_CB *Tcb
+  )
+/*++
+
+Routine Description:
+
+  Forget the SACK information, the receiver may renege on
+  the data it SACKed. RFC2018 requires this on retransmission
+  timeout.
+
+Arguments:
+
+  Tcb - Pointer to the TCP_CB of this TCP instance.
+
+Returns:
+
+  None.
+
+--*/
+{
+  NET_LIST_ENTRY  *Entry;
+
+  NET_LIST_FOR_EACH (Entry, &Tcb->SndQue) {
+    TCPSEG_NETBUF (NET_LIST_USER_STRUCT (Entry, NET_BUF, List))->Sacked = FALSE;
+  }
+
+  Tcb->SackHigh = Tcb->SndUna;
+}
+
 VOID
 TcpFastRecover (
   IN TCP_CB  *Tcb,
@@ -83,7 +359,7 @@ Returns:
     //
     FlightSize = TCP_SUB_SEQ (Tcb->SndNxt, Tcb->SndUna);
 
-    Tcb->Ssthresh     = NET_MAX (FlightSize >> 1, (UINT32) (2 * Tcb->SndMss));
+    TcpCubicOnLoss (Tcb, FlightSize);
     Tcb->Recover      = Tcb->SndNxt;
 
     Tcb->CongestState = TCP_CONGEST_RECOVER;
@@ -93,7 +369,8 @@ Returns:
     // Step 2: Entering fast retransmission
     //
     TcpRetransmit (Tcb, Tcb->SndUna);
-    Tcb->CWnd = Tcb->Ssthresh + 3 * Tcb->SndMss;
+    Tcb->CWnd           = Tcb->Ssthresh + 3 * Tcb->SndMss;
+    Tcb->SackRexmitNxt  = Tcb->SndUna + 1;
 
     TCP4_DEBUG_TRACE (("TcpFastRecover: enter fast retransmission"
       " for TCB %x, recover point is %d\n", Tcb, Tcb->Recover));
@@ -117,6 +394,14 @@ Returns:
     TCP4_DEBUG_TRACE (("TcpFastRecover: received another"
       " duplicated ACK (%d) for TCB %x\n", Seg->Ack, Tcb));
 
+    //
+    // With SACK, retransmit the next hole for each duplicated
+    // ACK instead of waiting for the partial ACKs one by one.
+    //
+    if (TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_RCVD_SACK)) {
+      TcpSackRetransmit (Tcb);
+    }
+
   } else {
 
     //
@@ -147,6 +432,10 @@ Returns:
       TcpRetransmit (Tcb, Seg->Ack);
       Acked = TCP_SUB_SEQ (Seg->Ack, Tcb->SndUna);
 
+      if (TCP_SEQ_LEQ (Tcb->SackRexmitNxt, Seg->Ack)) {
+        Tcb->SackRexmitNxt = Seg->Ack + 1;
+      }
+
       //
       // Deflate the CWnd by the amount of new data
       // ACKed by SEG.ACK. If more than one SMSS data
@@ -212,6 +501,15 @@ Returns:
       // fast retransmit the first unacknowledge field.
       //
       TcpRetransmit (Tcb, Seg->Ack);
+
+      if (TCP_SEQ_LEQ (Tcb->SackRexmitNxt, Seg->Ack)) {
+        Tcb->SackRexmitNxt = Seg->Ack + 1;
+      }
+
+      if (TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_RCVD_SACK)) {
+        TcpSackRetransmit (Tcb);
+      }
+
       TCP4_DEBUG_TRACE (("TcpFastLossRecover: received a "
         "partial ACK(%d) for TCB %x\n", Seg->Ack, Tcb));
     }
@@ -315,7 +613,8 @@ Returns:
   TCP_SEQNO Urg;
   UINT32    Drop;
 
-  Seg = TCPSEG_NETBUF (Nbuf);
+  Seg               = TCPSEG_NETBUF (Nbuf);
+  Seg->DataSumValid = FALSE;
 
   //
   // If the segment is completely out of window,
@@ -410,6 +709,60 @@ Returns:
   return TcpTrimSegment (Nbuf, Tcb->RcvNxt, Tcb->RcvWl2 + Tcb->RcvWnd);
 }
 
+STATIC
+VOID
+TcpRcvTuneBuffer (
+  IN TCP_CB *Tcb
+  )
+/*++
+
+Routine Description:
+
+  Grow the receive buffer if more than half of it was received
+  in sequence from the peer in the last RTT, so the advertised
+  window doesn't limit a connection with a large bandwidth delay
+  product.
+
+Arguments:
+
+  Tcb - Pointer to the TCP_CB of this TCP instance.
+
+Returns:
+
+  None.
+
+--*/
+{
+  UINT32  Rtt;
+  UINT32  Received;
+  UINT32  BufSize;
+
+  if (Tcb->RcvBufMax == 0) {
+    return ;
+  }
+
+  Rtt = NET_MAX (Tcb->SRtt >> TCP_RTT_SHIFT, 1);
+
+  if (TCP_SUB_TIME (mTcpTick, Tcb->RcvSpaceTick) < Rtt) {
+    return ;
+  }
+
+  Received  = TCP_SUB_SEQ (Tcb->RcvNxt, Tcb->RcvSpaceSeq);
+  BufSize   = GET_RCV_BUFFSIZE (Tcb->Sk);
+
+  if ((Received > BufSize / 2) && (BufSize < Tcb->RcvBufMax)) {
+
+    BufSize = NET_MIN (2 * BufSize, Tcb->RcvBufMax);
+    SET_RCV_BUFFSIZE (Tcb->Sk, BufSize);
+
+    TCP4_DEBUG_TRACE (("TcpRcvTuneBuffer: receive buffer of "
+      "TCB %x grows to %d\n", Tcb, BufSize));
+  }
+
+  Tcb->RcvSpaceSeq  = Tcb->RcvNxt;
+  Tcb->RcvSpaceTick = mTcpTick;
+}
+
 INTN
 TcpDeliverData (
   IN TCP_CB *Tcb
@@ -579,6 +932,7 @@ Returns:
     NetbufFree (Nbuf);
   }
 
+  TcpRcvTuneBuffer (Tcb);
   return 0;
 }
 
@@ -617,6 +971,14 @@ Returns:
   Seg   = TCPSEG_NETBUF (Nbuf);
   Head  = &Tcb->RcvQue;
 
+  //
+  // Remember the latest out-of-order segment, it
+  // is reported in the first SACK block.
+  //
+  if (TCP_SEQ_GT (Seg->Seq, Tcb->RcvNxt)) {
+    Tcb->RcvSackSeq = Seg->Seq;
+  }
+
   //
   // Fast path to process normal case. That is,
   // no out-of-order segments are received.
@@ -1174,6 +1536,16 @@ Returns:
     TcpSetTimer (Tcb, TCP_TIMER_REXMIT, Tcb->Rto);
   }
 
+  //
+  // Update the scoreboard before the ACK is used to
+  // recover from the loss.
+  //
+  if (TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_RCVD_SACK) &&
+      TCP_FLG_ON (Option.Flag, TCP_OPTION_RCVD_SACK)) {
+
+    TcpSackUpdate (Tcb, &Option);
+  }
+
   //
   // Count duplicate acks.
   //
@@ -1201,7 +1573,7 @@ Returns:
         Tcb->CWnd += Tcb->SndMss;
       } else {
 
-        Tcb->CWnd += NET_MAX (Tcb->SndMss * Tcb->SndMss / Tcb->CWnd, 1);
+        TcpCubicCongestAvoid (Tcb);
       }
 
       Tcb->CWnd = NET_MIN (Tcb->CWnd, TCP_MAX_WIN << Tcb->SndWndScale);
@@ -187,8 +187,7 @@ Returns:
     }
 
     Option = TcpConfigData->ControlOption;
-    if ((NULL != Option) &&
-      (Option->EnableSelectiveAck || Option->EnablePathMtuDiscovery)) {
+    if ((NULL != Option) && Option->EnablePathMtuDiscovery) {
       return EFI_UNSUPPORTED;
     }
   }
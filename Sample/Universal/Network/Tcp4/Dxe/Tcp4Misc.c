@@ -32,6 +32,9 @@ NET_LIST_ENTRY  mTcpListenQue = {
   &mTcpListenQue
 };
 
+NET_LIST_ENTRY  mTcpRunHash[TCP_HASH_SIZE];
+NET_LIST_ENTRY  mTcpListenHash[TCP_HASH_SIZE];
+
 TCP_SEQNO       mTcpGlobalIss = 0x4d7e980b;
 
 STATIC CHAR16   *mTcpStateName[] = {
@@ -85,8 +88,19 @@ Returns:
   Tcb->SndWl2 = Tcb->Iss;
   Tcb->SndWnd = 536;
 
+  Tcb->SackHigh = Tcb->Iss;
+
   Tcb->RcvWnd = GET_RCV_BUFFSIZE (Tcb->Sk);
 
+  //
+  // Tune the receive buffer only if the application
+  // didn't ask for a buffer smaller than the default.
+  //
+  Tcb->RcvBufMax = 0;
+  if (GET_RCV_BUFFSIZE (Tcb->Sk) >= TCP_RCV_BUF_SIZE) {
+    Tcb->RcvBufMax = TCP_RCV_BUF_SIZE_MAX;
+  }
+
   //
   // Fisrt window size is never scaled
   //
@@ -154,6 +168,10 @@ Returns:
 
   Tcb->RcvWl2 = Tcb->RcvNxt;
 
+  Tcb->RcvSackSeq   = Tcb->RcvNxt;
+  Tcb->RcvSpaceSeq  = Tcb->RcvNxt;
+  Tcb->RcvSpaceTick = mTcpTick;
+
   if (TCP_FLG_ON (Opt->Flag, TCP_OPTION_RCVD_WS) &&
       !TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_NO_WS)) {
 
@@ -165,8 +183,16 @@ Returns:
   } else {
     //
     // One end doesn't support window scale option. use zero.
+    // The window can't grow past 64K, so don't tune the buffer.
     //
-    Tcb->RcvWndScale = 0;
+    Tcb->RcvWndScale  = 0;
+    Tcb->RcvBufMax    = 0;
+  }
+
+  if (TCP_FLG_ON (Opt->Flag, TCP_OPTION_RCVD_SACK_PERM) &&
+      !TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_NO_SACK)) {
+
+    TCP_SET_FLG (Tcb->CtrlFlag, TCP_CTRL_RCVD_SACK);
   }
 
   if (TCP_FLG_ON (Opt->Flag, TCP_OPTION_RCVD_TS) &&
@@ -184,6 +210,66 @@ Returns:
   }
 }
 
+VOID
+TcpInitHash (
+  VOID
+  )
+/*++
+
+Routine Description:
+
+  Initialize the hash tables of the TCBs.
+
+Arguments:
+
+  None.
+
+Returns:
+
+  None.
+
+--*/
+{
+  UINTN Index;
+
+  for (Index = 0; Index < TCP_HASH_SIZE; Index++) {
+    NetListInit (&mTcpRunHash[Index]);
+    NetListInit (&mTcpListenHash[Index]);
+  }
+}
+
+STATIC
+UINTN
+TcpHashPeer (
+  IN TCP_PEER *Local,
+  IN TCP_PEER *Remote
+  )
+/*++
+
+Routine Description:
+
+  Compute the index of the socket pair in the mTcpRunHash.
+
+Arguments:
+
+  Local   - Pointer to the local (IP, Port).
+  Remote  - Pointer to the remote (IP, Port).
+
+Returns:
+
+  The index of the hash bucket.
+
+--*/
+{
+  UINT32  Hash;
+
+  Hash  = Local->Ip ^ Remote->Ip ^ (((UINT32) Local->Port << 16) | Remote->Port);
+  Hash ^= Hash >> 16;
+  Hash ^= Hash >> 8;
+
+  return Hash & (TCP_HASH_SIZE - 1);
+}
+
 STATIC
 TCP_CB *
 TcpLocateListenTcb (
@@ -216,8 +302,8 @@ Returns:
   Last  = 4;
   Match = NULL;
 
-  NET_LIST_FOR_EACH (Entry, &mTcpListenQue) {
-    Node = NET_LIST_USER_STRUCT (Entry, TCP_CB, List);
+  NET_LIST_FOR_EACH (Entry, &mTcpListenHash[TCP_HASH_PORT (Local->Port)]) {
+    Node = NET_LIST_USER_STRUCT (Entry, TCP_CB, HashList);
 
     if ((Local->Port != Node->LocalEnd.Port) ||
         !TCP_PEER_MATCH (Remote, &Node->RemoteEnd) ||
@@ -286,8 +372,8 @@ Returns:
 
   LocalPort = HTONS (Port);
 
-  NET_LIST_FOR_EACH (Entry, &mTcpListenQue) {
-    Tcb = NET_LIST_USER_STRUCT (Entry, TCP_CB, List);
+  NET_LIST_FOR_EACH (Entry, &mTcpListenHash[TCP_HASH_PORT (LocalPort)]) {
+    Tcb = NET_LIST_USER_STRUCT (Entry, TCP_CB, HashList);
 
     if (EFI_IP4_EQUAL (*Addr, Tcb->LocalEnd.Ip) &&
       (LocalPort == Tcb->LocalEnd.Port)) {
@@ -340,6 +426,7 @@ Returns:
 {
   TCP_PEER        Local;
   TCP_PEER        Remote;
+  NET_LIST_ENTRY  *Head;
   NET_LIST_ENTRY  *Entry;
   TCP_CB          *Tcb;
 
@@ -352,14 +439,16 @@ Returns:
   //
   // First check for exact match. 
   //
-  NET_LIST_FOR_EACH (Entry, &mTcpRunQue) {
-    Tcb = NET_LIST_USER_STRUCT (Entry, TCP_CB, List);
+  Head = &mTcpRunHash[TcpHashPeer (&Local, &Remote)];
+
+  NET_LIST_FOR_EACH (Entry, Head) {
+    Tcb = NET_LIST_USER_STRUCT (Entry, TCP_CB, HashList);
 
     if (TCP_PEER_EQUAL (&Remote, &Tcb->RemoteEnd) &&
         TCP_PEER_EQUAL (&Local, &Tcb->LocalEnd)) {
 
-      NetListRemoveEntry (&Tcb->List);
-      NetListInsertHead (&mTcpRunQue, &Tcb->List);
+      NetListRemoveEntry (&Tcb->HashList);
+      NetListInsertHead (Head, &Tcb->HashList);
 
       return Tcb;
     }
@@ -398,6 +487,7 @@ Returns:
 {
   NET_LIST_ENTRY   *Entry;
   NET_LIST_ENTRY   *Head;
+  NET_LIST_ENTRY   *Bucket;
   TCP_CB           *Node;
   TCP4_PROTO_DATA  *TcpProto;
 
@@ -415,17 +505,20 @@ Returns:
     return -1;
   }
 
-  Head = &mTcpRunQue;
+  Head    = &mTcpRunQue;
+  Bucket  = &mTcpRunHash[TcpHashPeer (&Tcb->LocalEnd, &Tcb->RemoteEnd)];
 
   if (Tcb->State == TCP_LISTEN) {
-    Head = &mTcpListenQue;
+    Head    = &mTcpListenQue;
+    Bucket  = &mTcpListenHash[TCP_HASH_PORT (Tcb->LocalEnd.Port)];
   }
 
   //
-  // Check that Tcb isn't already on the list.
+  // Check that Tcb isn't already on the list. The same
+  // socket pair always falls into the same bucket.
   //
-  NET_LIST_FOR_EACH (Entry, Head) {
-    Node = NET_LIST_USER_STRUCT (Entry, TCP_CB, List);
+  NET_LIST_FOR_EACH (Entry, Bucket) {
+    Node = NET_LIST_USER_STRUCT (Entry, TCP_CB, HashList);
 
     if (TCP_PEER_EQUAL (&Tcb->LocalEnd, &Node->LocalEnd) &&
         TCP_PEER_EQUAL (&Tcb->RemoteEnd, &Node->RemoteEnd)) {
@@ -435,6 +528,7 @@ Returns:
   }
 
   NetListInsertHead (Head, &Tcb->List);
+  NetListInsertHead (Bucket, &Tcb->HashList);
 
   TcpProto = (TCP4_PROTO_DATA *) Tcb->Sk->ProtoReserved;
   TcpSetVariableData (TcpProto->TcpService);
@@ -478,6 +572,7 @@ Returns:
   NET_GET_REF (Tcb->IpInfo);
 
   NetListInit (&Clone->List);
+  NetListInit (&Clone->HashList);
   NetListInit (&Clone->SndQue);
   NetListInit (&Clone->RcvQue);
 
@@ -93,6 +93,14 @@ Returns:
 
   BufSize = GET_RCV_BUFFSIZE (Tcb->Sk);
 
+  //
+  // The scale can't change after SYN, so leave
+  // room for the buffer to be tuned up.
+  //
+  if (Tcb->RcvBufMax > BufSize) {
+    BufSize = Tcb->RcvBufMax;
+  }
+
   Scale   = 0;
   while ((Scale < TCP_OPTION_MAX_WS) &&
          ((UINT32) (TCP_OPTION_MAX_WIN << Scale) < BufSize)) {
@@ -176,6 +184,26 @@ Returns:
     TcpPutUint32 (Data, TCP_OPTION_WS_FAST | TcpComputeScale (Tcb));
   }
 
+  //
+  // Build SACK permitted option, under the same
+  // rule as the window scale option.
+  //
+  if (!TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_NO_SACK) &&
+      (!TCP_FLG_ON (TCPSEG_NETBUF (Nbuf)->Flag, TCP_FLG_ACK) ||
+      TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_RCVD_SACK))) {
+
+    Data = NetbufAllocSpace (
+            Nbuf,
+            TCP_OPTION_SACK_PERM_ALIGNED_LEN,
+            NET_BUF_HEAD
+            );
+
+    ASSERT (Data);
+
+    Len += TCP_OPTION_SACK_PERM_ALIGNED_LEN;
+    TcpPutUint32 (Data, TCP_OPTION_SACK_PERM_FAST);
+  }
+
   //
   // Build MSS option
   //
@@ -188,6 +216,136 @@ Returns:
   return Len;
 }
 
+STATIC
+NET_LIST_ENTRY *
+TcpSackGetBlock (
+  IN  TCP_CB          *Tcb,
+  IN  NET_LIST_ENTRY  *Entry,
+  OUT TCP_SACK_BLOCK  *Block
+  )
+/*++
+
+Routine Description:
+
+  Get the block of contiguous data that starts from Entry
+  in the reassemble queue.
+
+Arguments:
+
+  Tcb   - Pointer to the TCP_CB of this TCP instance.
+  Entry - The first segment of the block.
+  Block - Pointer to the TCP_SACK_BLOCK to receive the block.
+
+Returns:
+
+  The segment following the block.
+
+--*/
+{
+  TCP_SEG *Seg;
+
+  Seg           = TCPSEG_NETBUF (NET_LIST_USER_STRUCT (Entry, NET_BUF, List));
+  Block->Left   = Seg->Seq;
+  Block->Right  = Seg->End;
+
+  for (Entry = Entry->ForwardLink; Entry != &Tcb->RcvQue; Entry = Entry->ForwardLink) {
+    Seg = TCPSEG_NETBUF (NET_LIST_USER_STRUCT (Entry, NET_BUF, List));
+
+    if (Seg->Seq != Block->Right) {
+      break;
+    }
+
+    Block->Right = Seg->End;
+  }
+
+  return Entry;
+}
+
+STATIC
+UINT16
+TcpSackBuildOption (
+  IN TCP_CB  *Tcb,
+  IN NET_BUF *Nbuf,
+  IN UINT8   MaxBlock
+  )
+/*++
+
+Routine Description:
+
+  Build the SACK option to report the out-of-order data in
+  the reassemble queue. As RFC2018 requires, the first block
+  contains the most recently received segment.
+
+Arguments:
+
+  Tcb       - Pointer to the TCP_CB of this TCP instance.
+  Nbuf      - Pointer to the buffer to store the options.
+  MaxBlock  - The maxium number of blocks to report.
+
+Returns:
+
+  The length of the SACK option.
+
+--*/
+{
+  TCP_SACK_BLOCK  Block[TCP_OPTION_MAX_SACK];
+  TCP_SACK_BLOCK  Cur;
+  NET_LIST_ENTRY  *Entry;
+  UINT8           *Data;
+  UINT8           Num;
+  UINT8           Index;
+  UINT16          Len;
+
+  ASSERT (MaxBlock <= TCP_OPTION_MAX_SACK);
+
+  Num = 0;
+
+  Entry = Tcb->RcvQue.ForwardLink;
+  while (Entry != &Tcb->RcvQue) {
+    Entry = TcpSackGetBlock (Tcb, Entry, &Cur);
+
+    if (TCP_SEQ_LEQ (Cur.Right, Tcb->RcvNxt)) {
+      continue;
+    }
+
+    if (TCP_SEQ_LEQ (Cur.Left, Tcb->RcvSackSeq) &&
+        TCP_SEQ_LT (Tcb->RcvSackSeq, Cur.Right)) {
+
+      Block[Num++] = Cur;
+      break;
+    }
+  }
+
+  Entry = Tcb->RcvQue.ForwardLink;
+  while ((Entry != &Tcb->RcvQue) && (Num < MaxBlock)) {
+    Entry = TcpSackGetBlock (Tcb, Entry, &Cur);
+
+    if (TCP_SEQ_LEQ (Cur.Right, Tcb->RcvNxt) ||
+        ((Num != 0) && (Cur.Left == Block[0].Left))) {
+      continue;
+    }
+
+    Block[Num++] = Cur;
+  }
+
+  if (Num == 0) {
+    return 0;
+  }
+
+  Len   = (UINT16) (4 + Num * TCP_OPTION_SACK_BLOCK_LEN);
+  Data  = NetbufAllocSpace (Nbuf, Len, NET_BUF_HEAD);
+  ASSERT (Data);
+
+  TcpPutUint32 (Data, TCP_OPTION_SACK_FAST | (Len - 2));
+
+  for (Index = 0; Index < Num; Index++) {
+    TcpPutUint32 (Data + 4 + Index * TCP_OPTION_SACK_BLOCK_LEN, Block[Index].Left);
+    TcpPutUint32 (Data + 8 + Index * TCP_OPTION_SACK_BLOCK_LEN, Block[Index].Right);
+  }
+
+  return Len;
+}
+
 UINT16
 TcpBuildOption (
   IN TCP_CB  *Tcb,
@@ -212,10 +370,29 @@ Returns:
 {
   char    *Data;
   UINT16  Len;
+  UINT8   MaxBlock;
 
   ASSERT (Tcb && Nbuf && !Nbuf->Tcp);
   Len = 0;
 
+  //
+  // Report the out-of-order data in segments without data,
+  // so a SACK option never pushes a data segment over the MSS.
+  //
+  if (TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_RCVD_SACK) &&
+      !TCP_FLG_ON (TCPSEG_NETBUF (Nbuf)->Flag, TCP_FLG_RST) &&
+      (Nbuf->TotalSize == 0) &&
+      !NetListIsEmpty (&Tcb->RcvQue)) {
+
+    MaxBlock = TCP_OPTION_MAX_SACK;
+
+    if (TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_SND_TS)) {
+      MaxBlock = TCP_OPTION_MAX_SACK_TS;
+    }
+
+    Len = (UINT16) (Len + TcpSackBuildOption (Tcb, Nbuf, MaxBlock));
+  }
+
   //
   // Build Timestamp option
   //
@@ -268,10 +445,12 @@ Returns:
   UINT8 Cur;
   UINT8 Type;
   UINT8 Len;
+  UINT8 Index;
 
   ASSERT (Tcp && Option);
 
-  Option->Flag  = 0;
+  Option->Flag    = 0;
+  Option->SackNum = 0;
 
   TotalLen      = (Tcp->HeadLen << 2) - sizeof (TCP_HEAD);
   if (TotalLen <= 0) {
@@ -348,6 +527,49 @@ Returns:
       Cur += TCP_OPTION_TS_LEN;
       break;
 
+    case TCP_OPTION_SACK_PERM:
+      Len = Head[Cur + 1];
+
+      if ((Len != TCP_OPTION_SACK_PERM_LEN) ||
+          (TotalLen - Cur < TCP_OPTION_SACK_PERM_LEN)) {
+
+        return -1;
+      }
+
+      TCP_SET_FLG (Option->Flag, TCP_OPTION_RCVD_SACK_PERM);
+
+      Cur += TCP_OPTION_SACK_PERM_LEN;
+      break;
+
+    case TCP_OPTION_SACK:
+      Len = Head[Cur + 1];
+
+      if ((Len < 2 + TCP_OPTION_SACK_BLOCK_LEN) ||
+          ((Len - 2) % TCP_OPTION_SACK_BLOCK_LEN != 0) ||
+          (TotalLen - Cur < Len)) {
+
+        return -1;
+      }
+
+      for (Index = 0; Index < (Len - 2) / TCP_OPTION_SACK_BLOCK_LEN; Index++) {
+        if (Option->SackNum == TCP_OPTION_MAX_SACK) {
+          break;
+        }
+
+        Option->Sack[Option->SackNum].Left  = TcpGetUint32 (
+                                                &Head[Cur + 2 + Index * TCP_OPTION_SACK_BLOCK_LEN]
+                                                );
+        Option->Sack[Option->SackNum].Right = TcpGetUint32 (
+                                                &Head[Cur + 6 + Index * TCP_OPTION_SACK_BLOCK_LEN]
+                                                );
+        Option->SackNum++;
+      }
+
+      TCP_SET_FLG (Option->Flag, TCP_OPTION_RCVD_SACK);
+
+      Cur = (UINT8) (Cur + Len);
+      break;
+
     case TCP_OPTION_NOP:
       Cur++;
       break;
@@ -20,18 +20,6 @@ Abstract:
 #ifndef _TCP4_OPTION_H_
 #define _TCP4_OPTION_H_
 
-//
-// The structure to store the parse option value.
-// ParseOption only parse the options, don't process them.
-//
-typedef struct s_TCP_OPTION {
-  UINT8   Flag;     // flag such as TCP_OPTION_RCVD_MSS
-  UINT8   WndScale; // the WndScale received
-  UINT16  Mss;      // the Mss received
-  UINT32  TSVal;    // the TSVal field in a timestamp option
-  UINT32  TSEcr;    // the TSEcr field in a timestamp option
-} TCP_OPTION;
-
 enum {
 
   //
@@ -41,11 +29,16 @@ enum {
   TCP_OPTION_NOP            = 1,  // No-Option.
   TCP_OPTION_MSS            = 2,  // Maximum Segment Size
   TCP_OPTION_WS             = 3,  // Window scale
+  TCP_OPTION_SACK_PERM      = 4,  // SACK permitted, RFC2018
+  TCP_OPTION_SACK           = 5,  // SACK blocks, RFC2018
   TCP_OPTION_TS             = 8,  // Timestamp
   TCP_OPTION_MSS_LEN        = 4,  // length of MSS option
   TCP_OPTION_WS_LEN         = 3,  // length of window scale option
+  TCP_OPTION_SACK_PERM_LEN  = 2,  // length of SACK permitted option
+  TCP_OPTION_SACK_BLOCK_LEN = 8,  // length of each SACK block
   TCP_OPTION_TS_LEN         = 10, // length of timestamp option
   TCP_OPTION_WS_ALIGNED_LEN = 4,  // length of window scale option, aligned
+  TCP_OPTION_SACK_PERM_ALIGNED_LEN = 4, // length of SACK permitted, aligned
   TCP_OPTION_TS_ALIGNED_LEN = 12, // length of timestamp option, aligned
 
   //
@@ -64,6 +57,18 @@ enum {
   TCP_OPTION_MSS_FAST = ((TCP_OPTION_MSS << 24) |
                          (TCP_OPTION_MSS_LEN << 16)),
 
+  TCP_OPTION_SACK_PERM_FAST = ((TCP_OPTION_NOP << 24) |
+                               (TCP_OPTION_NOP << 16) |
+                               (TCP_OPTION_SACK_PERM << 8) |
+                               TCP_OPTION_SACK_PERM_LEN),
+
+  //
+  // The length of the SACK option is or'ed in
+  //
+  TCP_OPTION_SACK_FAST = ((TCP_OPTION_NOP << 24) |
+                          (TCP_OPTION_NOP << 16) |
+                          (TCP_OPTION_SACK << 8)),
+
   //
   // Other misc definations
   //
@@ -72,8 +77,36 @@ enum {
   TCP_OPTION_RCVD_MSS       = 0x01,
   TCP_OPTION_RCVD_WS        = 0x02,
   TCP_OPTION_RCVD_TS        = 0x04,
+  TCP_OPTION_RCVD_SACK_PERM = 0x08,
+  TCP_OPTION_RCVD_SACK      = 0x10,
+
+  //
+  // Maxium number of SACK blocks in a segment, three
+  // if the timestamp option is also sent.
+  //
+  TCP_OPTION_MAX_SACK       = 4,
+  TCP_OPTION_MAX_SACK_TS    = 3,
 };
 
+typedef struct s_TCP_SACK_BLOCK {
+  TCP_SEQNO Left;   // first sequence of the block
+  TCP_SEQNO Right;  // sequence of the last byte + 1
+} TCP_SACK_BLOCK;
+
+//
+// The structure to store the parse option value.
+// ParseOption only parse the options, don't process them.
+//
+typedef struct s_TCP_OPTION {
+  UINT8           Flag;     // flag such as TCP_OPTION_RCVD_MSS
+  UINT8           WndScale; // the WndScale received
+  UINT16          Mss;      // the Mss received
+  UINT32          TSVal;    // the TSVal field in a timestamp option
+  UINT32          TSEcr;    // the TSEcr field in a timestamp option
+  UINT8           SackNum;  // the number of SACK blocks received
+  TCP_SACK_BLOCK  Sack[TCP_OPTION_MAX_SACK];
+} TCP_OPTION;
+
 UINT8
 TcpComputeScale (
   IN TCP_CB *Tcb
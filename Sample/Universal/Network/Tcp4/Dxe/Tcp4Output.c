@@ -341,6 +341,7 @@ Returns:
   TCP_SEG   *Seg;
   BOOLEAN   Syn;
   UINT32    DataLen;
+  UINT16    Checksum;
 
   ASSERT (Nbuf && (Nbuf->Tcp == NULL) && TcpVerifySegment (Nbuf));
 
@@ -349,6 +350,15 @@ Returns:
   Seg     = TCPSEG_NETBUF (Nbuf);
   Syn     = TCP_FLG_ON (Seg->Flag, TCP_FLG_SYN);
 
+  //
+  // Sum the data before the head is prepended. The TCP head is a multiple
+  // of 4 bytes long, so the data sum can be added to the head's as is.
+  //
+  if (!Seg->DataSumValid) {
+    Seg->DataSum      = NetbufChecksum (Nbuf);
+    Seg->DataSumValid = TRUE;
+  }
+
   if (Syn) {
 
     Len = TcpSynBuildOption (Tcb, Nbuf);
@@ -424,7 +434,12 @@ Returns:
 
   Head->Flag      = Seg->Flag;
   Head->Urg       = NTOHS (Seg->Urg);
-  Head->Checksum  = TcpChecksum (Nbuf, Tcb->HeadSum);
+
+  Checksum        = NetblockChecksum ((UINT8 *) Head, Len);
+  Checksum        = NetAddChecksum (Checksum, Seg->DataSum);
+  Checksum        = NetAddChecksum (Checksum, Tcb->HeadSum);
+  Checksum        = NetAddChecksum (Checksum, HTONS ((UINT16) Nbuf->TotalSize));
+  Head->Checksum  = ~Checksum;
 
   //
   // update the TCP session's control information
@@ -581,9 +596,10 @@ Returns:
 
   NetCopyMem (TCPSEG_NETBUF (Nbuf), Seg, sizeof (TCP_SEG));
 
-  TCPSEG_NETBUF (Nbuf)->Seq   = Seq;
-  TCPSEG_NETBUF (Nbuf)->End   = End;
-  TCPSEG_NETBUF (Nbuf)->Flag  = Flag;
+  TCPSEG_NETBUF (Nbuf)->Seq           = Seq;
+  TCPSEG_NETBUF (Nbuf)->End           = End;
+  TCPSEG_NETBUF (Nbuf)->Flag          = Flag;
+  TCPSEG_NETBUF (Nbuf)->DataSumValid  = FALSE;
 
   return Nbuf;
 
@@ -622,6 +638,18 @@ Returns:
 
   ASSERT (Tcb && Tcb->Sk);
 
+  //
+  // Reference the data of the zero-copy send tokens in place.
+  // The segment may be shorter than Len at the token boundary.
+  //
+  Nbuf = SockGetDataRef (Tcb->Sk, Len, TCP_MAX_HEAD);
+
+  if (Nbuf != NULL) {
+    Len     = Nbuf->TotalSize;
+    DataGet = Len;
+    goto ON_QUEUE;
+  }
+
   Nbuf = NetbufAlloc (Len + TCP_MAX_HEAD);
 
   if (Nbuf == NULL) {
@@ -645,6 +673,7 @@ Returns:
     DataGet = SockGetDataToSend (Tcb->Sk, 0, Len, Data);
   }
 
+ON_QUEUE:
   NET_GET_REF (Nbuf);
 
   TCPSEG_NETBUF (Nbuf)->Seq = Seq;
@@ -778,6 +807,50 @@ OnError:
   return -1;
 }
 
+INTN
+TcpSackRetransmit (
+  IN TCP_CB *Tcb
+  )
+/*++
+
+Routine Description:
+
+  Retransmit the first segment not SACKed by the receiver that
+  has SACKed data above it, and hasn't been retransmitted in
+  this recovery yet.
+
+Arguments:
+
+  Tcb - Pointer to the TCP_CB of this TCP instance.
+
+Returns:
+
+  0   - A hole is retransmitted or there is none.
+  -1  - Error condition occurred.
+
+--*/
+{
+  NET_LIST_ENTRY  *Entry;
+  TCP_SEG         *Seg;
+
+  NET_LIST_FOR_EACH (Entry, &Tcb->SndQue) {
+    Seg = TCPSEG_NETBUF (NET_LIST_USER_STRUCT (Entry, NET_BUF, List));
+
+    if (TCP_SEQ_GEQ (Seg->Seq, Tcb->SackHigh)) {
+      break;
+    }
+
+    if (Seg->Sacked || TCP_SEQ_LT (Seg->Seq, Tcb->SackRexmitNxt)) {
+      continue;
+    }
+
+    Tcb->SackRexmitNxt = Seg->End;
+    return TcpRetransmit (Tcb, Seg->Seq);
+  }
+
+  return 0;
+}
+
 INTN
 TcpToSendData (
   IN TCP_CB *Tcb,
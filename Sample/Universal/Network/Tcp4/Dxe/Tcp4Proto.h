@@ -93,6 +93,8 @@ enum {
   TCP_CTRL_TIMER_ON       = 0x1000, // At least one of the timer is on
   TCP_CTRL_RTT_ON         = 0x2000, // The RTT measurement is on
   TCP_CTRL_ACK_NOW        = 0x4000, // Send the ACK now, don't delay
+  TCP_CTRL_NO_SACK        = 0x8000, // disable SACK option
+  TCP_CTRL_RCVD_SACK      = 0x10000,// rcvd a SACK permitted option in syn
 
   //
   // Timer related values
@@ -134,6 +136,7 @@ enum {
   //
   TCP_RCV_BUF_SIZE        = 2 *1024 *1024,
   TCP_RCV_BUF_SIZE_MIN    = 8 *1024,
+  TCP_RCV_BUF_SIZE_MAX    = 8 *1024 *1024,  // limit of receive buffer tuning
   TCP_SND_BUF_SIZE        = 2 *1024 *1024,
   TCP_SND_BUF_SIZE_MIN    = 8 *1024,
   TCP_BACKLOG             = 10,
@@ -145,6 +148,20 @@ enum {
   TCP_KEEPALIVE_PERIOD_MIN= TCP_TICK_HZ *30,
   TCP_FIN_WAIT2_TIME_MAX  = 4 *TCP_TICK_HZ,
   TCP_TIME_WAIT_TIME_MAX  = 60 *TCP_TICK_HZ,
+
+  //
+  // CUBIC congestion avoidance, W(t) = C * (t - K)^3 + Wmax with
+  // C = 0.4, t in seconds and W in segments. The window is reduced
+  // to 7/10 on loss, and Wmax to 17/20 of the window if the window
+  // hasn't recovered to the last Wmax (fast convergence).
+  //
+  TCP_CUBIC_C_NUM         = 2,        // C = 2 / 5
+  TCP_CUBIC_C_DEN         = 5 *TCP_TICK_HZ *TCP_TICK_HZ *TCP_TICK_HZ,
+  TCP_CUBIC_BETA_NUM      = 7,
+  TCP_CUBIC_BETA_DEN      = 10,
+  TCP_CUBIC_CONV_NUM      = 17,
+  TCP_CUBIC_CONV_DEN      = 20,
+  TCP_CUBIC_MAX_TIME      = 1024,     // clamp of |t - K|, in ticks
 };
 
 typedef struct _TCP_SEG {
@@ -155,6 +172,18 @@ typedef struct _TCP_SEG {
   UINT8     Flag; // TCP header flags
   UINT16    Urg;  // Valid if URG flag is set.
   UINT32    Wnd;  // TCP window size field
+
+  //
+  // Checksum of the segment's data, kept while the segment waits on
+  // the SndQue so a retransmit doesn't sum the data again.
+  //
+  UINT16    DataSum;
+  BOOLEAN   DataSumValid;
+
+  //
+  // The segment on the SndQue has been selectively acknowledged.
+  //
+  BOOLEAN   Sacked;
 } TCP_SEG;
 
 typedef struct _TCP_PEER {
@@ -167,6 +196,7 @@ typedef struct _TCP_PEER {
 //
 typedef struct _TCP_CB {
   NET_LIST_ENTRY    List;
+  NET_LIST_ENTRY    HashList;     // Link in the mTcpRunHash or mTcpListenHash
   TCP_CB            *Parent;
 
   SOCKET            *Sk;
@@ -245,6 +275,30 @@ typedef struct _TCP_CB {
   UINT8             LossTimes;    // number of retxmit timeouts in a row
   TCP_SEQNO         LossRecover;  // recover point for retxmit
 
+  //
+  // RFC2018 variables, the sender's scoreboard is kept
+  // in the TCP_SEG of the segments on the SndQue.
+  //
+  TCP_SEQNO         SackHigh;      // highest sequence SACKed by the peer
+  TCP_SEQNO         SackRexmitNxt; // holes below it are retransmitted
+  TCP_SEQNO         RcvSackSeq;    // the last out-of-order segment received
+
+  //
+  // CUBIC congestion avoidance variables.
+  //
+  UINT32            CubicWMax;    // window before the last reduction
+  UINT32            CubicOrigin;  // origin of the cubic, 0 if no epoch
+  UINT32            CubicEpoch;   // the tick the current epoch started
+  UINT32            CubicK;       // ticks to reach CubicOrigin
+
+  //
+  // Receive buffer tuning, the buffer grows when the
+  // peer fills more than half of it in one RTT.
+  //
+  UINT32            RcvBufMax;    // limit of the buffer, 0 if not tuned
+  TCP_SEQNO         RcvSpaceSeq;  // RcvNxt at the start of the measure
+  UINT32            RcvSpaceTick; // when the measure is started
+
   //
   // configuration parameters, for EFI_TCP4_PROTOCOL specification
   //
@@ -273,6 +327,8 @@ typedef struct _TCP_CB {
 
 extern NET_LIST_ENTRY mTcpRunQue;
 extern NET_LIST_ENTRY mTcpListenQue;
+extern NET_LIST_ENTRY mTcpRunHash[];
+extern NET_LIST_ENTRY mTcpListenHash[];
 extern TCP_SEQNO      mTcpGlobalIss;
 extern UINT32         mTcpTick;
 
@@ -321,6 +377,15 @@ extern UINT32         mTcpTick;
 #define TCP_SET_FLG(Value, Flag)    ((Value) |= (Flag))
 #define TCP_CLEAR_FLG(Value, Flag)  ((Value) &= ~(Flag))
 
+//
+// The TCBs on the mTcpRunQue are also hashed by the socket pair, and
+// those on the mTcpListenQue by the local port, to demultiplex the
+// segments without walking all the connections.
+//
+#define TCP_HASH_SIZE         256
+
+#define TCP_HASH_PORT(Port)   (((Port) ^ ((Port) >> 8)) & (TCP_HASH_SIZE - 1))
+
 //
 // test whether two peers are equal
 //
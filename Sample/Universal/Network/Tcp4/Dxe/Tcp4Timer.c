@@ -167,7 +167,7 @@ Returns:
   // yet ACKed.
   //
   FlightSize        = TCP_SUB_SEQ (Tcb->SndNxt, Tcb->SndUna);
-  Tcb->Ssthresh     = NET_MAX ((UINT32) (2 * Tcb->SndMss), FlightSize / 2);
+  TcpCubicOnLoss (Tcb, FlightSize);
 
   Tcb->CWnd         = Tcb->SndMss;
   Tcb->LossRecover  = Tcb->SndNxt;
@@ -188,7 +188,9 @@ Returns:
   }
 
   TcpBackoffRto (Tcb);
+  TcpSackClear (Tcb);
   TcpRetransmit (Tcb, Tcb->SndUna);
+  Tcb->SackRexmitNxt = Tcb->SndUna + 1;
   TcpSetTimer (Tcb, TCP_TIMER_REXMIT, Tcb->Rto);
 
   Tcb->CongestState = TCP_CONGEST_LOSS;
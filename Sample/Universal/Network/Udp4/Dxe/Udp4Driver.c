@@ -230,6 +230,7 @@ Returns:
     Udp4CleanService (Udp4Service);
 
     NetFreePool (Udp4Service);
+    NetbufCacheFlush ();
   } else {
 
     while (!NetListIsEmpty (&Udp4Service->ChildrenList)) {
@@ -25,7 +25,8 @@ UINT8 *mMtftpOptions[PXE_MTFTP_OPTION_MAXIMUM_INDEX] = {
   "blksize",
   "timeout",
   "tsize",
-  "multicast"
+  "multicast",
+  "windowsize"
 };
 
 EFI_STATUS
@@ -206,6 +207,64 @@ ON_ERROR:
   return Status;
 }
 
+STATIC
+EFI_STATUS
+PxeBcTftpAbortPacket (
+  IN EFI_MTFTP4_PROTOCOL        *This,
+  IN EFI_MTFTP4_TOKEN           *Token,
+  IN UINT16                     PacketLen,
+  IN EFI_MTFTP4_PACKET          *Packet
+  )
+/*++
+
+Routine Description:
+
+  CheckPacket callback installed when the user aborted a download, so
+  Mtftp4 ends it with an ERROR packet to the server.
+
+Arguments:
+
+  This      - Pointer to Mtftp protocol instance
+  Token     - Pointer to Mtftp token 
+  PacketLen - Length of Mtftp packet
+  Packet    - Pointer to Mtftp packet
+
+Returns:
+
+  EFI_ABORTED
+
+--*/
+{
+  return EFI_ABORTED;
+}
+
+STATIC
+EFI_STATUS
+PxeBcTftpAbortTimeout (
+  IN EFI_MTFTP4_PROTOCOL        *This,
+  IN EFI_MTFTP4_TOKEN           *Token
+  )
+/*++
+
+Routine Description:
+
+  TimeoutCallback installed when the user aborted a download, in case
+  the server sends nothing more.
+
+Arguments:
+
+  This      - Pointer to Mtftp protocol instance
+  Token     - Pointer to Mtftp token 
+
+Returns:
+
+  EFI_ABORTED
+
+--*/
+{
+  return EFI_ABORTED;
+}
+
 EFI_STATUS
 PxeBcTftpReadFile (
   IN PXEBC_PRIVATE_DATA         *Private,
@@ -220,7 +279,13 @@ PxeBcTftpReadFile (
 
 Routine Description:
 
-  This function is to get data of a file by Tftp.
+  This function is to get data of a file by Tftp. Mtftp4 flattens every
+  fragmented DATA packet for the CheckPacket callback, so the callback is 
+  only registered if there is no buffer or a PXE callback may want to see
+  the packets. The LoadFile's own callback only checks for an ESC key, it
+  is called every PXE_MTFTP_KEY_CHECK_PERIOD while polling the download
+  instead. The data is then copied only once, from the received fragments
+  to the buffer.
 
 Arguments:
 
@@ -241,14 +306,21 @@ Returns:
 {
   EFI_MTFTP4_PROTOCOL *Mtftp4;
   EFI_MTFTP4_TOKEN    Token;
-  EFI_MTFTP4_OPTION   ReqOpt[1];
+  EFI_MTFTP4_OPTION   ReqOpt[2];
   UINT32              OptCnt;
   UINT8               OptBuf[128];
+  BOOLEAN             IsDone;
+  BOOLEAN             Aborted;
+  EFI_EVENT           KeyEvent;
   EFI_STATUS          Status;
 
   Status                    = EFI_DEVICE_ERROR;
   Mtftp4                    = Private->Mtftp4;
   OptCnt                    = 0;
+  IsDone                    = FALSE;
+  Aborted                   = FALSE;
+  KeyEvent                  = NULL;
+  Token.Event               = NULL;
   Config->InitialServerPort = PXEBC_BS_DOWNLOAD_PORT;
 
   Status = Mtftp4->Configure (Mtftp4, Config);
@@ -265,6 +337,19 @@ Returns:
     OptCnt++;
   }
 
+  //
+  // Ask for a sliding window. A server without RFC 7440 support
+  // ignores the option, others may answer with a smaller window.
+  //
+  ReqOpt[OptCnt].OptionStr  = mMtftpOptions[PXE_MTFTP_OPTION_WINDOWSIZE_INDEX];
+  ReqOpt[OptCnt].ValueStr   = OptBuf;
+  if (OptCnt != 0) {
+    ReqOpt[OptCnt].ValueStr = ReqOpt[0].ValueStr + EfiAsciiStrLen (ReqOpt[0].ValueStr) + 1;
+  }
+
+  UtoA10 (PXE_MTFTP_DEFAULT_WINDOWSIZE, ReqOpt[OptCnt].ValueStr);
+  OptCnt++;
+
   Token.Event         = NULL;
   Token.OverrideData  = NULL;
   Token.Filename      = Filename;
@@ -285,12 +370,86 @@ Returns:
   Token.TimeoutCallback = NULL;
   Token.PacketNeeded    = NULL;
 
+  //
+  // Without a buffer, CheckPacket is the only way to collect the data.
+  //
+  if ((Token.Buffer != NULL) && (Private->PxeBcCallback == NULL)) {
+    Token.CheckPacket = NULL;
+
+  } else if ((Token.Buffer != NULL) && (Private->PxeBcCallback == &Private->LoadFileCallback)) {
+    Token.CheckPacket = NULL;
+
+    Status = gBS->CreateEvent (
+                    EFI_EVENT_TIMER,
+                    EFI_TPL_CALLBACK,
+                    NULL,
+                    NULL,
+                    &KeyEvent
+                    );
+    if (EFI_ERROR (Status)) {
+      goto ON_EXIT;
+    }
+
+    Status = gBS->SetTimer (KeyEvent, TimerPeriodic, PXE_MTFTP_KEY_CHECK_PERIOD);
+    if (EFI_ERROR (Status)) {
+      goto ON_EXIT;
+    }
+
+    Status = gBS->CreateEvent (
+                    EFI_EVENT_NOTIFY_SIGNAL,
+                    NET_TPL_EVENT,
+                    PxeBcCommonNotify,
+                    &IsDone,
+                    &Token.Event
+                    );
+    if (EFI_ERROR (Status)) {
+      Token.Event = NULL;
+      goto ON_EXIT;
+    }
+  }
+
   Status = Mtftp4->ReadFile (Mtftp4, &Token);
 
+  if (Token.Event != NULL) {
+
+    while (!EFI_ERROR (Status) && !IsDone) {
+
+      Mtftp4->Poll (Mtftp4);
+
+      if (Aborted || EFI_ERROR (gBS->CheckEvent (KeyEvent))) {
+        continue;
+      }
+
+      if (EFI_ERROR (PxeBcCheckPacket (Mtftp4, &Token, 0, NULL))) {
+        //
+        // Let Mtftp4 fail the next packet or time out, so it sends
+        // the server an ERROR packet before it ends the download.
+        //
+        Aborted               = TRUE;
+        Token.CheckPacket     = PxeBcTftpAbortPacket;
+        Token.TimeoutCallback = PxeBcTftpAbortTimeout;
+      }
+    }
+
+    if (!EFI_ERROR (Status)) {
+      Status = Token.Status;
+    }
+  }
+
   *BufferSize = Token.BufferSize;
 
+ON_EXIT:
+
   Mtftp4->Configure (Mtftp4, NULL);
 
+  if (Token.Event != NULL) {
+    gBS->CloseEvent (Token.Event);
+  }
+
+  if (KeyEvent != NULL) {
+    gBS->CloseEvent (KeyEvent);
+  }
+
   return Status;
 }
 
@@ -27,9 +27,21 @@ enum {
   PXE_MTFTP_OPTION_TIMEOUT_INDEX,
   PXE_MTFTP_OPTION_TSIZE_INDEX,
   PXE_MTFTP_OPTION_MULTICAST_INDEX,
+  PXE_MTFTP_OPTION_WINDOWSIZE_INDEX,
   PXE_MTFTP_OPTION_MAXIMUM_INDEX
 };
 
+//
+// Number of blocks the server may send before waiting for an ACK,
+// requested with the RFC 7440 windowsize option.
+//
+#define PXE_MTFTP_DEFAULT_WINDOWSIZE  4
+
+//
+// How often the LoadFile download checks for an ESC key.
+//
+#define PXE_MTFTP_KEY_CHECK_PERIOD    (100 * TICKS_PER_MS)
+
 EFI_STATUS
 PxeBcTftpGetFileSize (
   IN PXEBC_PRIVATE_DATA         *Private,
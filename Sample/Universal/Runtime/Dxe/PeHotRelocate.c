@@ -22,6 +22,12 @@ Abstract:
 #include "Runtime.h"
 
 extern VOID                          *mMyImageBase;
+extern EFI_RUNTIME_ARCH_PROTOCOL     mRuntime;
+
+//
+// Fixup tables of the runtime images, see RuntimeDriverImageNotify ().
+//
+EFI_LIST_ENTRY                       mFixupTableHead = INITIALIZE_LIST_HEAD_VARIABLE (mFixupTableHead);
 
 VOID *
 RuntimePeImageAddress (
@@ -52,66 +58,46 @@ Returns:
   return (CHAR8 *) ((UINTN) Image->ImageBase + Address);
 }
 
-VOID
-RelocatePeImageForRuntime (
-  IN EFI_RUNTIME_IMAGE_ENTRY     *Image
+STATIC
+EFI_STATUS
+RuntimePeImageRelocDir (
+  IN   EFI_RUNTIME_IMAGE_ENTRY        *Image,
+  OUT  EFI_IMAGE_BASE_RELOCATION      **RelocBase,
+  OUT  EFI_IMAGE_BASE_RELOCATION      **RelocBaseEnd
   )
 /*++
 
 Routine Description:
 
-  Relocate runtime images.
+  Find the relocation directory of a loaded image.
 
 Arguments:
 
-  Image   - Points to the relocation data of the image.
+  Image         - The relocation data of the image.
+  RelocBase     - Start of the relocation directory.
+  RelocBaseEnd  - End of the relocation directory.
 
 Returns:
 
-  None.
+  EFI_SUCCESS     - The relocation directory was found.
+  EFI_NOT_FOUND   - The image is not a PE image or has no relocations.
 
---*/  
+--*/
 {
-  EFI_STATUS                            Status;
-  CHAR8                                 *OldBase;
-  CHAR8                                 *NewBase;
+  CHAR8                                 *ImageBase;
   EFI_IMAGE_DOS_HEADER                  *DosHdr;
   EFI_IMAGE_OPTIONAL_HEADER_PTR_UNION   Hdr;
   UINT32                                NumberOfRvaAndSizes;
   EFI_IMAGE_DATA_DIRECTORY              *DataDirectory;
   EFI_IMAGE_DATA_DIRECTORY              *RelocDir;
-  EFI_IMAGE_BASE_RELOCATION             *RelocBase;
-  EFI_IMAGE_BASE_RELOCATION             *RelocBaseEnd;
-  UINT16                                *Reloc;
-  UINT16                                *RelocEnd;
-  CHAR8                                 *Fixup;
-  CHAR8                                 *FixupBase;
-  UINT16                                *F16;
-  UINT32                                *F32;
-  UINT64                                *F64;
-  CHAR8                                 *FixupData;
-  UINTN                                 Adjust;
   UINT16                                Magic;
-  
-  if (mMyImageBase == (VOID *) (UINTN) Image->ImageBase) {
-    //
-    // We don't want to relocate our selves, as we only run in physical mode.
-    //
-    return;
-  }
-  
-  OldBase = (CHAR8 *) ((UINTN) Image->ImageBase);
-  NewBase = (CHAR8 *) ((UINTN) Image->ImageBase);
-
-  Status  = RuntimeDriverConvertPointer (0, &NewBase);
-  ASSERT_EFI_ERROR (Status);
 
-  Adjust = (UINTN) NewBase - (UINTN) OldBase;
+  ImageBase = (CHAR8 *) ((UINTN) Image->ImageBase);
 
   //
   // Find the image's relocate dir info.
   //
-  DosHdr = (EFI_IMAGE_DOS_HEADER *) OldBase;
+  DosHdr = (EFI_IMAGE_DOS_HEADER *) ImageBase;
   if (DosHdr->e_magic == EFI_IMAGE_DOS_SIGNATURE) {
     //
     // Valid DOS header so get address of PE header.
@@ -121,14 +107,14 @@ Returns:
     //
     // No Dos header so assume image starts with PE header.
     //
-    Hdr.Pe32 = (EFI_IMAGE_NT_HEADERS32 *) OldBase;
+    Hdr.Pe32 = (EFI_IMAGE_NT_HEADERS32 *) ImageBase;
   }
 
   if (Hdr.Pe32->Signature != EFI_IMAGE_NT_SIGNATURE) {
     //
     // Not a valid PE image so Exit.
     //
-    return;
+    return EFI_NOT_FOUND;
   }
   
   //
@@ -169,19 +155,392 @@ Returns:
   // is present in the image. You have to check the NumberOfRvaAndSizes in
   // the optional header to verify a desired directory entry is there.
   //
-  if (NumberOfRvaAndSizes > EFI_IMAGE_DIRECTORY_ENTRY_BASERELOC) {
-    RelocDir      = DataDirectory + EFI_IMAGE_DIRECTORY_ENTRY_BASERELOC;
-    RelocBase     = RuntimePeImageAddress (Image, RelocDir->VirtualAddress);
-    RelocBaseEnd  = RuntimePeImageAddress (Image, RelocDir->VirtualAddress + RelocDir->Size);
-  } else {
+  if (NumberOfRvaAndSizes <= EFI_IMAGE_DIRECTORY_ENTRY_BASERELOC) {
     //
     // Cannot find relocations, cannot continue.
     //
     ASSERT (FALSE);
+    return EFI_NOT_FOUND;
+  }
+
+  RelocDir      = DataDirectory + EFI_IMAGE_DIRECTORY_ENTRY_BASERELOC;
+  *RelocBase    = RuntimePeImageAddress (Image, RelocDir->VirtualAddress);
+  *RelocBaseEnd = RuntimePeImageAddress (Image, RelocDir->VirtualAddress + RelocDir->Size);
+
+  ASSERT (*RelocBase != NULL && *RelocBaseEnd != NULL);
+  if (*RelocBase == NULL || *RelocBaseEnd == NULL) {
+    return EFI_NOT_FOUND;
+  }
+
+  return EFI_SUCCESS;
+}
+
+STATIC
+EFI_STATUS
+RuntimeFlattenRelocations (
+  IN     EFI_IMAGE_BASE_RELOCATION    *RelocBase,
+  IN     EFI_IMAGE_BASE_RELOCATION    *RelocBaseEnd,
+  OUT    UINT32                       *Fixup OPTIONAL,
+  OUT    UINTN                        *Count
+  )
+/*++
+
+Routine Description:
+
+  Convert a relocation directory into fixup table entries, dropping the
+  padding entries. Called once with Fixup NULL to size the table.
+
+Arguments:
+
+  RelocBase     - Start of the relocation directory.
+  RelocBaseEnd  - End of the relocation directory.
+  Fixup         - Receives the entries, may be NULL.
+  Count         - Number of entries.
+
+Returns:
+
+  EFI_SUCCESS     - The directory was converted.
+  EFI_UNSUPPORTED - The directory holds a processor specific relocation or
+                    an offset that does not fit an entry, so the image has
+                    to be relocated by walking the directory.
+
+--*/
+{
+  UINT16  *Reloc;
+  UINT16  *RelocEnd;
+  UINT32  Offset;
+  UINT32  Type;
+
+  *Count = 0;
+  while (RelocBase < RelocBaseEnd) {
+    Reloc     = (UINT16 *) ((UINT8 *) RelocBase + sizeof (EFI_IMAGE_BASE_RELOCATION));
+    RelocEnd  = (UINT16 *) ((UINT8 *) RelocBase + RelocBase->SizeOfBlock);
+
+    for (; Reloc < RelocEnd; Reloc++) {
+      Type    = (*Reloc) >> 12;
+      Offset  = RelocBase->VirtualAddress + (*Reloc & 0xFFF);
+
+      switch (Type) {
+      case EFI_IMAGE_REL_BASED_ABSOLUTE:
+        continue;
+
+      case EFI_IMAGE_REL_BASED_HIGH:
+      case EFI_IMAGE_REL_BASED_LOW:
+      case EFI_IMAGE_REL_BASED_HIGHLOW:
+      case EFI_IMAGE_REL_BASED_DIR64:
+        break;
+
+      default:
+        return EFI_UNSUPPORTED;
+      }
+
+      if (Offset > RUNTIME_FIXUP_OFFSET_MASK) {
+        return EFI_UNSUPPORTED;
+      }
+
+      if (Fixup != NULL) {
+        Fixup[*Count] = (Type << RUNTIME_FIXUP_TYPE_SHIFT) | Offset;
+      }
+
+      *Count += 1;
+    }
+
+    RelocBase = (EFI_IMAGE_BASE_RELOCATION *) RelocEnd;
+  }
+
+  return EFI_SUCCESS;
+}
+
+STATIC
+RUNTIME_FIXUP_TABLE *
+RuntimeBuildFixupTable (
+  IN EFI_RUNTIME_IMAGE_ENTRY     *Image
+  )
+/*++
+
+Routine Description:
+
+  Build the fixup table of a runtime image.
+
+Arguments:
+
+  Image   - Points to the relocation data of the image.
+
+Returns:
+
+  The fixup table, or NULL if the image has to be relocated by walking its
+  relocation directory.
+
+--*/
+{
+  EFI_STATUS                  Status;
+  EFI_IMAGE_BASE_RELOCATION   *RelocBase;
+  EFI_IMAGE_BASE_RELOCATION   *RelocBaseEnd;
+  RUNTIME_FIXUP_TABLE         *Table;
+  UINTN                       Count;
+
+  Status = RuntimePeImageRelocDir (Image, &RelocBase, &RelocBaseEnd);
+  if (EFI_ERROR (Status)) {
+    return NULL;
+  }
+
+  Status = RuntimeFlattenRelocations (RelocBase, RelocBaseEnd, NULL, &Count);
+  if (EFI_ERROR (Status)) {
+    return NULL;
+  }
+
+  //
+  // The table is used after ExitBootServices (), so it must be runtime memory.
+  //
+  Status = gBS->AllocatePool (
+                  EfiRuntimeServicesData,
+                  sizeof (RUNTIME_FIXUP_TABLE) + Count * sizeof (UINT32),
+                  (VOID **) &Table
+                  );
+  if (EFI_ERROR (Status)) {
+    return NULL;
+  }
+
+  RuntimeFlattenRelocations (RelocBase, RelocBaseEnd, Table->Fixup, &Table->Count);
+
+  Table->Signature      = RUNTIME_FIXUP_TABLE_SIGNATURE;
+  Table->Image          = Image;
+  Table->ImageBase      = Image->ImageBase;
+  Table->ImageSize      = Image->ImageSize;
+  Table->RelocationData = Image->RelocationData;
+
+  return Table;
+}
+
+STATIC
+RUNTIME_FIXUP_TABLE *
+RuntimeFindFixupTable (
+  IN EFI_RUNTIME_IMAGE_ENTRY     *Image
+  )
+{
+  EFI_LIST_ENTRY          *Link;
+  RUNTIME_FIXUP_TABLE     *Table;
+
+  for (Link = mFixupTableHead.ForwardLink; Link != &mFixupTableHead; Link = Link->ForwardLink) {
+    Table = RUNTIME_FIXUP_TABLE_FROM_LINK (Link);
+    //
+    // An entry freed by UnloadImage () may have been reused by another image.
+    //
+    if (Table->Image == Image &&
+        Table->ImageBase == Image->ImageBase &&
+        Table->ImageSize == Image->ImageSize &&
+        Table->RelocationData == Image->RelocationData) {
+      return Table;
+    }
+  }
+
+  return NULL;
+}
+
+VOID
+EFIAPI
+RuntimeDriverImageNotify (
+  IN EFI_EVENT                   Event,
+  IN VOID                        *Context
+  )
+/*++
+
+Routine Description:
+
+  Called every time an image is loaded. Build the fixup table of every new
+  runtime image, and free the tables of runtime images that were unloaded.
+
+Arguments:
+
+  Event   - The Loaded Image protocol notification event.
+  Context - Not used.
+
+Returns:
+
+  None.
+
+--*/
+{
+  EFI_LIST_ENTRY              *Link;
+  EFI_LIST_ENTRY              *ImageLink;
+  EFI_RUNTIME_IMAGE_ENTRY     *RuntimeImage;
+  RUNTIME_FIXUP_TABLE         *Table;
+
+  Link = mFixupTableHead.ForwardLink;
+  while (Link != &mFixupTableHead) {
+    Table = RUNTIME_FIXUP_TABLE_FROM_LINK (Link);
+    Link  = Link->ForwardLink;
+
+    for (ImageLink = mRuntime.ImageHead.ForwardLink; ImageLink != &mRuntime.ImageHead; ImageLink = ImageLink->ForwardLink) {
+      RuntimeImage = _CR (ImageLink, EFI_RUNTIME_IMAGE_ENTRY, Link);
+      if (RuntimeImage == Table->Image) {
+        break;
+      }
+    }
+
+    if (ImageLink == &mRuntime.ImageHead) {
+      RemoveEntryList (&Table->Link);
+      gBS->FreePool (Table);
+    }
+  }
+
+  for (ImageLink = mRuntime.ImageHead.ForwardLink; ImageLink != &mRuntime.ImageHead; ImageLink = ImageLink->ForwardLink) {
+    RuntimeImage = _CR (ImageLink, EFI_RUNTIME_IMAGE_ENTRY, Link);
+    if (mMyImageBase == RuntimeImage->ImageBase || RuntimeFindFixupTable (RuntimeImage) != NULL) {
+      continue;
+    }
+
+    Table = RuntimeBuildFixupTable (RuntimeImage);
+    if (Table != NULL) {
+      InsertTailList (&mFixupTableHead, &Table->Link);
+    }
+  }
+}
+
+STATIC
+VOID
+RuntimeApplyFixupTable (
+  IN RUNTIME_FIXUP_TABLE         *Table,
+  IN UINTN                       Adjust
+  )
+/*++
+
+Routine Description:
+
+  Relocate a runtime image from its fixup table. Like the directory walk in
+  RelocatePeImageForRuntime (), only values that still match the fixup log
+  are adjusted.
+
+Arguments:
+
+  Table   - The image's fixup table.
+  Adjust  - The offset to adjust the fixups by.
+
+Returns:
+
+  None.
+
+--*/
+{
+  CHAR8                                 *ImageBase;
+  CHAR8                                 *Fixup;
+  CHAR8                                 *FixupData;
+  UINT16                                *F16;
+  UINT32                                *F32;
+  UINT64                                *F64;
+  UINTN                                 Index;
+
+  ImageBase = (CHAR8 *) Table->ImageBase;
+  FixupData = Table->RelocationData;
+
+  for (Index = 0; Index < Table->Count; Index++) {
+    Fixup = ImageBase + (Table->Fixup[Index] & RUNTIME_FIXUP_OFFSET_MASK);
+    switch (Table->Fixup[Index] >> RUNTIME_FIXUP_TYPE_SHIFT) {
+
+    case EFI_IMAGE_REL_BASED_HIGH:
+      F16 = (UINT16 *) Fixup;
+      if (*(UINT16 *) FixupData == *F16) {
+        *F16  = (UINT16) (*F16 + (UINT16)(((UINT32)Adjust) >> 16));
+      }
+
+      FixupData = FixupData + sizeof (UINT16);
+      break;
+
+    case EFI_IMAGE_REL_BASED_LOW:
+      F16 = (UINT16 *) Fixup;
+      if (*(UINT16 *) FixupData == *F16) {
+        *F16 = (UINT16) (*F16 + ((UINT16) Adjust & 0xffff));
+      }
+
+      FixupData = FixupData + sizeof (UINT16);
+      break;
+
+    case EFI_IMAGE_REL_BASED_HIGHLOW:
+      F32       = (UINT32 *) Fixup;
+      FixupData = ALIGN_POINTER (FixupData, sizeof (UINT32));
+      if (*(UINT32 *) FixupData == *F32) {
+        *F32 = *F32 + (UINT32) Adjust;
+      }
+
+      FixupData = FixupData + sizeof (UINT32);
+      break;
+
+    default:
+      F64       = (UINT64 *)Fixup;
+      FixupData = ALIGN_POINTER (FixupData, sizeof (UINT64));
+      if (*(UINT64 *) FixupData == *F64) {
+        *F64 = *F64 + (UINT64)Adjust;
+      }
+
+      FixupData = FixupData + sizeof (UINT64);
+      break;
+    }
+  }
+}
+
+VOID
+RelocatePeImageForRuntime (
+  IN EFI_RUNTIME_IMAGE_ENTRY     *Image
+  )
+/*++
+
+Routine Description:
+
+  Relocate runtime images. The fixup table built when the image was loaded
+  is used if there is one, otherwise the relocation directory is walked.
+
+Arguments:
+
+  Image   - Points to the relocation data of the image.
+
+Returns:
+
+  None.
+
+--*/  
+{
+  EFI_STATUS                            Status;
+  CHAR8                                 *OldBase;
+  CHAR8                                 *NewBase;
+  EFI_IMAGE_BASE_RELOCATION             *RelocBase;
+  EFI_IMAGE_BASE_RELOCATION             *RelocBaseEnd;
+  UINT16                                *Reloc;
+  UINT16                                *RelocEnd;
+  CHAR8                                 *Fixup;
+  CHAR8                                 *FixupBase;
+  UINT16                                *F16;
+  UINT32                                *F32;
+  UINT64                                *F64;
+  CHAR8                                 *FixupData;
+  UINTN                                 Adjust;
+  RUNTIME_FIXUP_TABLE                   *Table;
+  
+  if (mMyImageBase == (VOID *) (UINTN) Image->ImageBase) {
+    //
+    // We don't want to relocate our selves, as we only run in physical mode.
+    //
     return;
   }
+  
+  OldBase = (CHAR8 *) ((UINTN) Image->ImageBase);
+  NewBase = (CHAR8 *) ((UINTN) Image->ImageBase);
+
+  Status  = RuntimeDriverConvertPointer (0, &NewBase);
+  ASSERT_EFI_ERROR (Status);
 
-  ASSERT (RelocBase != NULL && RelocBaseEnd != NULL);
+  Adjust = (UINTN) NewBase - (UINTN) OldBase;
+
+  Table = RuntimeFindFixupTable (Image);
+  if (Table != NULL) {
+    RuntimeApplyFixupTable (Table, Adjust);
+    EfiCpuFlushCache ((EFI_PHYSICAL_ADDRESS) Image->ImageBase, (UINT64) Image->ImageSize);
+    return;
+  }
+
+  Status = RuntimePeImageRelocDir (Image, &RelocBase, &RelocBaseEnd);
+  if (EFI_ERROR (Status)) {
+    return;
+  }
 
   //
   // Run the whole relocation block. And re-fixup data that has not been
@@ -64,6 +64,14 @@ EFI_MEMORY_DESCRIPTOR         *mVirtualMap                = NULL;
 UINTN                         mVirtualMapDescriptorSize;
 UINTN                         mVirtualMapMaxIndex;
 
+//
+// Runtime descriptors of mVirtualMap sorted by PhysicalStart, so pointers
+// can be converted with a binary search. Empty if the map has too many
+// runtime descriptors.
+//
+EFI_MEMORY_DESCRIPTOR         *mSortedRuntimeMap[RUNTIME_MAX_SORTED_DESCRIPTORS];
+UINTN                         mSortedRuntimeMapCount;
+
 VOID                          *mMyImageBase;
 EFI_SYSTEM_TABLE              *mMyST;
 EFI_RUNTIME_SERVICES          *mMyRT;
@@ -97,6 +105,111 @@ EFI_RUNTIME_ARCH_PROTOCOL     mRuntime = {
 //
 // Worker Functions
 //
+STATIC
+VOID
+RuntimeDriverSortVirtualMap (
+  VOID
+  )
+/*++
+
+Routine Description:
+
+  Collect the runtime descriptors of mVirtualMap into mSortedRuntimeMap in
+  ascending PhysicalStart order. Memory can not be allocated here, so maps
+  with more runtime descriptors than mSortedRuntimeMap holds are left to
+  the linear search.
+
+Arguments:
+
+  None.
+
+Returns:
+
+  None.
+
+--*/
+{
+  EFI_MEMORY_DESCRIPTOR *VirtEntry;
+  UINTN                 Index;
+  UINTN                 Position;
+
+  mSortedRuntimeMapCount  = 0;
+  VirtEntry               = mVirtualMap;
+  for (Index = 0; Index < mVirtualMapMaxIndex; Index++) {
+    if ((VirtEntry->Attribute & EFI_MEMORY_RUNTIME) == EFI_MEMORY_RUNTIME) {
+      if (mSortedRuntimeMapCount == RUNTIME_MAX_SORTED_DESCRIPTORS) {
+        mSortedRuntimeMapCount = 0;
+        return;
+      }
+      //
+      // The map is usually sorted already, so insertion sort is cheap.
+      //
+      for (Position = mSortedRuntimeMapCount; Position > 0; Position--) {
+        if (mSortedRuntimeMap[Position - 1]->PhysicalStart <= VirtEntry->PhysicalStart) {
+          break;
+        }
+
+        mSortedRuntimeMap[Position] = mSortedRuntimeMap[Position - 1];
+      }
+
+      mSortedRuntimeMap[Position] = VirtEntry;
+      mSortedRuntimeMapCount++;
+    }
+
+    VirtEntry = NextMemoryDescriptor (VirtEntry, mVirtualMapDescriptorSize);
+  }
+}
+
+STATIC
+EFI_MEMORY_DESCRIPTOR *
+RuntimeDriverFindDescriptor (
+  IN UINTN                  Address
+  )
+/*++
+
+Routine Description:
+
+  Binary search mSortedRuntimeMap for the runtime descriptor that contains
+  Address.
+
+Arguments:
+
+  Address - Physical address to look up.
+
+Returns:
+
+  The descriptor, or NULL if no runtime descriptor contains Address.
+
+--*/
+{
+  UINTN                 Low;
+  UINTN                 High;
+  UINTN                 Middle;
+  EFI_MEMORY_DESCRIPTOR *VirtEntry;
+
+  Low   = 0;
+  High  = mSortedRuntimeMapCount;
+  while (Low < High) {
+    Middle = Low + (High - Low) / 2;
+    if (mSortedRuntimeMap[Middle]->PhysicalStart <= Address) {
+      Low = Middle + 1;
+    } else {
+      High = Middle;
+    }
+  }
+
+  if (Low == 0) {
+    return NULL;
+  }
+
+  VirtEntry = mSortedRuntimeMap[Low - 1];
+  if (Address >= VirtEntry->PhysicalStart + (((UINTN) VirtEntry->NumberOfPages) * EFI_PAGE_SIZE)) {
+    return NULL;
+  }
+
+  return VirtEntry;
+}
+
 VOID
 RuntimeDriverCalculateEfiHdrCrc (
   IN OUT EFI_TABLE_HEADER  *Hdr
@@ -183,6 +296,20 @@ Returns:
     return EFI_INVALID_PARAMETER;
   }
 
+  if (mSortedRuntimeMapCount != 0) {
+    VirtEntry = RuntimeDriverFindDescriptor (Address);
+    if (VirtEntry != NULL) {
+      *ConvertAddress = (VOID *) (Address - (UINTN) VirtEntry->PhysicalStart + (UINTN) VirtEntry->VirtualStart);
+      return EFI_SUCCESS;
+    }
+    //
+    // Only an IPF GP outside of every image needs the linear search below.
+    //
+    if ((DebugDisposition & EFI_IPF_GP_POINTER) == 0) {
+      return EFI_NOT_FOUND;
+    }
+  }
+
   PlabelConvertAddress  = NULL;
   VirtEntry             = mVirtualMap;
   for (Index = 0; Index < mVirtualMapMaxIndex; Index++) {
@@ -327,6 +454,7 @@ Returns:
   mVirtualMapDescriptorSize = DescriptorSize;
   mVirtualMapMaxIndex       = MemoryMapSize / DescriptorSize;
   mVirtualMap               = VirtualMap;
+  RuntimeDriverSortVirtualMap ();
 
   //
   // Currently the bug in StatusCode/RuntimeLib has been fixed, it will
@@ -426,7 +554,8 @@ Returns:
   //
   // mVirtualMap is only valid during SetVirtualAddressMap() call.
   //
-  mVirtualMap = NULL;
+  mVirtualMap             = NULL;
+  mSortedRuntimeMapCount  = 0;
 
   return EFI_SUCCESS;
 }
@@ -459,6 +588,7 @@ Returns:
 {
   EFI_STATUS                Status;
   EFI_LOADED_IMAGE_PROTOCOL *MyLoadedImage;
+  VOID                      *Registration;
 
   //
   // Initialize EFI Runtime Driver.
@@ -495,6 +625,18 @@ Returns:
   gBS->CalculateCrc32         = RuntimeDriverCalculateCrc32;
   mMyRT->SetVirtualAddressMap = RuntimeDriverSetVirtualAddressMap;
   mMyRT->ConvertPointer       = RuntimeDriverConvertPointer;
+
+  //
+  // Flatten the relocations of each runtime image as it is loaded, rather
+  // than parsing them in SetVirtualAddressMap().
+  //
+  RtEfiLibCreateProtocolNotifyEvent (
+    &gEfiLoadedImageProtocolGuid,
+    EFI_TPL_CALLBACK,
+    RuntimeDriverImageNotify,
+    NULL,
+    &Registration
+    );
   
   //
   // Install the Runtime Architectural Protocol onto a new handle
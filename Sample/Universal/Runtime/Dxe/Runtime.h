@@ -48,9 +48,64 @@ Abstract:
 //
 #include EFI_ARCH_PROTOCOL_PRODUCER (Runtime)
 
+//
+// A runtime image's relocations, flattened when the image is loaded so that
+// SetVirtualAddressMap () only has to patch. Each entry holds the relocation
+// type in the top 4 bits and the image offset it applies to below them.
+//
+#define RUNTIME_FIXUP_TYPE_SHIFT        28
+#define RUNTIME_FIXUP_OFFSET_MASK       0x0FFFFFFF
+
+#define RUNTIME_FIXUP_TABLE_SIGNATURE   EFI_SIGNATURE_32 ('R', 'T', 'F', 'X')
+typedef struct {
+  UINTN                   Signature;
+  EFI_LIST_ENTRY          Link;
+  EFI_RUNTIME_IMAGE_ENTRY *Image;
+  VOID                    *ImageBase;
+  UINT64                  ImageSize;
+  VOID                    *RelocationData;
+  UINTN                   Count;
+  UINT32                  Fixup[1];
+} RUNTIME_FIXUP_TABLE;
+
+#define RUNTIME_FIXUP_TABLE_FROM_LINK(a) \
+  CR (a, RUNTIME_FIXUP_TABLE, Link, RUNTIME_FIXUP_TABLE_SIGNATURE)
+
+//
+// Maximum number of runtime descriptors SetVirtualAddressMap () sorts for
+// RuntimeDriverConvertPointer (). Pointers are looked up in larger maps
+// linearly.
+//
+#define RUNTIME_MAX_SORTED_DESCRIPTORS  256
+
 //
 // Function Prototypes
 //
+VOID
+EFIAPI
+RuntimeDriverImageNotify (
+  IN EFI_EVENT                Event,
+  IN VOID                     *Context
+  )
+/*++
+
+Routine Description:
+
+  Called every time an image is loaded. Build the fixup table of every new
+  runtime image, and free the tables of runtime images that were unloaded.
+
+Arguments:
+
+  Event   - The Loaded Image protocol notification event.
+  Context - Not used.
+
+Returns:
+
+  None.
+
+--*/
+;
+
 VOID
 RelocatePeImageForRuntime (
   IN EFI_RUNTIME_IMAGE_ENTRY  *Image
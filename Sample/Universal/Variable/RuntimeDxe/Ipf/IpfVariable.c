@@ -140,6 +140,10 @@ Returns:
     EFI_INTERNAL_POINTER,
     (VOID **) &mVariableModuleGlobal->VariableBase[Virtual].VolatileVariableBase
     );
+  EfiConvertPointer (
+    EFI_OPTIONAL_POINTER,
+    (VOID **) &mVariableModuleGlobal->VariableBase[Virtual].VariableIndexBase
+    );
   EfiConvertPointer (EFI_INTERNAL_POINTER, (VOID **) &mVariableModuleGlobal);
 }
 
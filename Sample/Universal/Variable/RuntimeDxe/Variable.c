@@ -381,6 +381,340 @@ Returns:
   return FALSE;
 }
 
+UINT32
+GetVariableIndexHash (
+  IN  CHAR16                  *VariableName,
+  IN  EFI_GUID                *VendorGuid
+  )
+/*++
+
+Routine Description:
+
+  Compute the variable index hash of a (VendorGuid, VariableName) pair.
+
+Arguments:
+
+  VariableName                Null-terminated variable name
+  VendorGuid                  Variable vendor GUID
+
+Returns:
+
+  The hash value
+
+--*/
+{
+  UINT32  Hash;
+
+  Hash = VendorGuid->Data1;
+  while (*VariableName != 0) {
+    Hash = (Hash * 31) + *VariableName;
+    VariableName++;
+  }
+
+  return Hash;
+}
+
+VOID
+AddVariableIndexEntry (
+  IN  VARIABLE_GLOBAL         *Global,
+  IN  BOOLEAN                 Volatile,
+  IN  VARIABLE_HEADER         *Variable
+  )
+/*++
+
+Routine Description:
+
+  Record a variable header that has been appended to a variable store.
+  If the index is full it is marked invalid and lookups walk the stores
+  until the index is rebuilt.
+
+Arguments:
+
+  Global                      Pointer to VARIABLE_GLOBAL structure
+  Volatile                    The variable lives in the volatile store or not
+  Variable                    Pointer to the variable header in the store
+
+Returns:
+
+  None
+
+--*/
+{
+  VARIABLE_INDEX        *VariableIndex;
+  VARIABLE_INDEX_ENTRY  *Entry;
+  EFI_PHYSICAL_ADDRESS  StoreBase;
+  UINTN                 Bucket;
+
+  VariableIndex = (VARIABLE_INDEX *) (UINTN) Global->VariableIndexBase;
+  if (VariableIndex == NULL || !VariableIndex->Valid) {
+    return;
+  }
+
+  if (VariableIndex->Count >= VariableIndex->MaxCount) {
+    VariableIndex->Valid = FALSE;
+    return;
+  }
+
+  StoreBase = Volatile ? Global->VolatileVariableBase : Global->NonVolatileVariableBase;
+
+  Entry           = &VariableIndex->Entry[VariableIndex->Count];
+  Entry->Hash     = GetVariableIndexHash (GET_VARIABLE_NAME_PTR (Variable), &Variable->VendorGuid);
+  Entry->Offset   = (UINT32) ((UINTN) Variable - (UINTN) StoreBase);
+  Entry->Volatile = (UINT8) Volatile;
+  Entry->Reserved = 0;
+
+  Bucket                        = Entry->Hash % VARIABLE_INDEX_BUCKETS;
+  Entry->Next                   = VariableIndex->Bucket[Bucket];
+  VariableIndex->Bucket[Bucket] = (UINT16) VariableIndex->Count;
+  VariableIndex->Count++;
+}
+
+VOID
+RebuildVariableIndex (
+  IN  VARIABLE_GLOBAL         *Global
+  )
+/*++
+
+Routine Description:
+
+  Rebuild the variable index from the contents of both variable stores.
+  Called after a store has been rewritten by Reclaim.
+
+Arguments:
+
+  Global                      Pointer to VARIABLE_GLOBAL structure
+
+Returns:
+
+  None
+
+--*/
+{
+  VARIABLE_INDEX        *VariableIndex;
+  VARIABLE_STORE_HEADER *VariableStoreHeader[2];
+  VARIABLE_HEADER       *Variable;
+  VARIABLE_HEADER       *EndPtr;
+  UINTN                 Index;
+
+  VariableIndex = (VARIABLE_INDEX *) (UINTN) Global->VariableIndexBase;
+  if (VariableIndex == NULL) {
+    return;
+  }
+
+  VariableIndex->Valid = TRUE;
+  VariableIndex->Count = 0;
+  EfiSetMem (VariableIndex->Bucket, sizeof (VariableIndex->Bucket), 0xff);
+
+  //
+  // 0: Non-Volatile, 1: Volatile
+  //
+  VariableStoreHeader[0]  = (VARIABLE_STORE_HEADER *) ((UINTN) Global->NonVolatileVariableBase);
+  VariableStoreHeader[1]  = (VARIABLE_STORE_HEADER *) ((UINTN) Global->VolatileVariableBase);
+
+  for (Index = 0; Index < 2; Index++) {
+    Variable = (VARIABLE_HEADER *) (VariableStoreHeader[Index] + 1);
+    EndPtr   = GetEndPointer (VariableStoreHeader[Index]);
+    while (IsValidVariableHeader (Variable) && (Variable < EndPtr)) {
+      AddVariableIndexEntry (Global, (BOOLEAN) Index, Variable);
+      Variable = GetNextVariablePtr (Variable);
+    }
+  }
+}
+
+EFI_STATUS
+CreateVariableIndex (
+  IN  VARIABLE_GLOBAL         *Global
+  )
+/*++
+
+Routine Description:
+
+  Allocate the variable index, sized for the smallest possible variable in
+  both stores, and build it.
+
+Arguments:
+
+  Global                      Pointer to VARIABLE_GLOBAL structure
+
+Returns:
+
+  EFI_SUCCESS                 - The index was built
+  EFI_OUT_OF_RESOURCES        - No memory for the index; lookups walk the stores
+
+--*/
+{
+  EFI_STATUS      Status;
+  VARIABLE_INDEX  *VariableIndex;
+  UINTN           MaxCount;
+
+  MaxCount = (((VARIABLE_STORE_HEADER *) (UINTN) Global->NonVolatileVariableBase)->Size +
+              ((VARIABLE_STORE_HEADER *) (UINTN) Global->VolatileVariableBase)->Size) /
+             (sizeof (VARIABLE_HEADER) + 2 * sizeof (CHAR16));
+  if (MaxCount > VARIABLE_INDEX_MAX_COUNT) {
+    MaxCount = VARIABLE_INDEX_MAX_COUNT;
+  }
+
+  Status = gBS->AllocatePool (
+                  EfiRuntimeServicesData,
+                  sizeof (VARIABLE_INDEX) + (MaxCount - 1) * sizeof (VARIABLE_INDEX_ENTRY),
+                  &VariableIndex
+                  );
+  if (EFI_ERROR (Status)) {
+    Global->VariableIndexBase = 0;
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  VariableIndex->MaxCount   = MaxCount;
+  Global->VariableIndexBase = (EFI_PHYSICAL_ADDRESS) (UINTN) VariableIndex;
+  RebuildVariableIndex (Global);
+
+  return EFI_SUCCESS;
+}
+
+EFI_STATUS
+FindVariableInIndex (
+  IN  CHAR16                  *VariableName,
+  IN  EFI_GUID                *VendorGuid,
+  OUT VARIABLE_POINTER_TRACK  *PtrTrack,
+  IN  VARIABLE_GLOBAL         *Global,
+  IN  VARIABLE_INDEX          *VariableIndex
+  )
+/*++
+
+Routine Description:
+
+  Index-based equivalent of the store walk in FindVariable. Only the
+  variables in the matching hash chain are examined. As with the walk, the
+  first VAR_ADDED copy in store order (non-volatile before volatile) wins,
+  and otherwise the last VAR_IN_DELETED_TRANSITION copy is returned.
+
+Arguments:
+
+  VariableName                Name of the variable to be found, not empty
+  VendorGuid                  Vendor GUID to be found.
+  PtrTrack                    Variable Track Pointer structure that contains
+                              Variable Information.
+  Global                      VARIABLE_GLOBAL pointer
+  VariableIndex               The variable index
+
+Returns:
+
+  EFI_SUCCESS                 - Find the specified variable
+  EFI_NOT_FOUND               - Not found
+
+--*/
+{
+  VARIABLE_STORE_HEADER *VariableStoreHeader[2];
+  VARIABLE_INDEX_ENTRY  *Entry;
+  VARIABLE_INDEX_ENTRY  *Found;
+  VARIABLE_INDEX_ENTRY  *InDelete;
+  VARIABLE_HEADER       *Variable;
+  UINT16                EntryIndex;
+  UINT32                Hash;
+  UINTN                 NameSize;
+
+  VariableStoreHeader[0]  = (VARIABLE_STORE_HEADER *) ((UINTN) Global->NonVolatileVariableBase);
+  VariableStoreHeader[1]  = (VARIABLE_STORE_HEADER *) ((UINTN) Global->VolatileVariableBase);
+
+  Hash      = GetVariableIndexHash (VariableName, VendorGuid);
+  NameSize  = EfiStrSize (VariableName);
+  Found     = NULL;
+  InDelete  = NULL;
+
+  EntryIndex = VariableIndex->Bucket[Hash % VARIABLE_INDEX_BUCKETS];
+  while (EntryIndex != VARIABLE_INDEX_END) {
+    Entry       = &VariableIndex->Entry[EntryIndex];
+    EntryIndex  = Entry->Next;
+    if (Entry->Hash != Hash) {
+      continue;
+    }
+
+    Variable = (VARIABLE_HEADER *) ((UINTN) VariableStoreHeader[Entry->Volatile] + Entry->Offset);
+    if (EfiAtRuntime () && !(Variable->Attributes & EFI_VARIABLE_RUNTIME_ACCESS)) {
+      continue;
+    }
+    if (!EfiCompareGuid (VendorGuid, &Variable->VendorGuid) ||
+        EfiCompareMem (VariableName, GET_VARIABLE_NAME_PTR (Variable), NameSize) != 0) {
+      continue;
+    }
+
+    if (Variable->State == VAR_ADDED) {
+      if ((Found == NULL) ||
+          (Entry->Volatile < Found->Volatile) ||
+          ((Entry->Volatile == Found->Volatile) && (Entry->Offset < Found->Offset))) {
+        Found = Entry;
+      }
+    } else if (Variable->State == (VAR_ADDED & VAR_IN_DELETED_TRANSITION)) {
+      if ((InDelete == NULL) ||
+          (Entry->Volatile > InDelete->Volatile) ||
+          ((Entry->Volatile == InDelete->Volatile) && (Entry->Offset > InDelete->Offset))) {
+        InDelete = Entry;
+      }
+    }
+  }
+
+  if (Found == NULL) {
+    Found = InDelete;
+  }
+
+  if (Found == NULL) {
+    PtrTrack->CurrPtr = NULL;
+    return EFI_NOT_FOUND;
+  }
+
+  PtrTrack->CurrPtr  = (VARIABLE_HEADER *) ((UINTN) VariableStoreHeader[Found->Volatile] + Found->Offset);
+  PtrTrack->StartPtr = (VARIABLE_HEADER *) (VariableStoreHeader[Found->Volatile] + 1);
+  PtrTrack->EndPtr   = GetEndPointer (VariableStoreHeader[Found->Volatile]);
+  PtrTrack->Volatile = (BOOLEAN) Found->Volatile;
+  return EFI_SUCCESS;
+}
+
+UINTN
+GetVariableStoreLiveSize (
+  IN  EFI_PHYSICAL_ADDRESS  VariableBase,
+  IN  VARIABLE_HEADER       *CurrentVariable OPTIONAL
+  )
+/*++
+
+Routine Description:
+
+  Get the lower bound of the store size Reclaim would leave behind, without
+  doing the reclaim. VAR_IN_DELETED_TRANSITION variables other than
+  CurrentVariable are counted as reclaimable, since Reclaim drops them when
+  a newer copy exists.
+
+Arguments:
+
+  VariableBase                Base address of variable store
+  CurrentVariable             The variable being updated, kept by Reclaim
+
+Returns:
+
+  Size of the store header plus all variables that are certain to survive
+
+--*/
+{
+  VARIABLE_HEADER       *Variable;
+  VARIABLE_HEADER       *NextVariable;
+  VARIABLE_STORE_HEADER *VariableStoreHeader;
+  UINTN                 LiveSize;
+
+  VariableStoreHeader = (VARIABLE_STORE_HEADER *) ((UINTN) VariableBase);
+  Variable            = (VARIABLE_HEADER *) (VariableStoreHeader + 1);
+  LiveSize            = sizeof (VARIABLE_STORE_HEADER);
+
+  while (IsValidVariableHeader (Variable)) {
+    NextVariable = GetNextVariablePtr (Variable);
+    if ((Variable->State == VAR_ADDED) ||
+        ((Variable == CurrentVariable) && (Variable->State == (VAR_ADDED & VAR_IN_DELETED_TRANSITION)))) {
+      LiveSize += (UINTN) NextVariable - (UINTN) Variable;
+    }
+    Variable = NextVariable;
+  }
+
+  return LiveSize;
+}
+
 EFI_STATUS
 Reclaim (
   IN  EFI_PHYSICAL_ADDRESS  VariableBase,
@@ -487,6 +821,17 @@ Returns:
     Variable = NextVariable;
   }
 
+  if (!IsVolatile &&
+      EfiCompareMem (ValidBuffer, VariableStoreHeader, VariableStoreHeader->Size) == 0) {
+    //
+    // Nothing to reclaim, the store already holds exactly the compacted image.
+    // Skip the FTW cycle rather than erase and rewrite identical flash.
+    //
+    *LastVariableOffset = ValidBufferSize;
+    gBS->FreePool (ValidBuffer);
+    return EFI_SUCCESS;
+  }
+
   if (IsVolatile) {
     //
     // If volatile variable store, just copy valid buffer
@@ -555,11 +900,17 @@ Returns:
   UINTN                 InDeleteIndex;
   VARIABLE_HEADER       *InDeleteStartPtr;
   VARIABLE_HEADER       *InDeleteEndPtr;
+  VARIABLE_INDEX        *VariableIndex;
 
   if (VariableName[0] != 0 && VendorGuid == NULL) {
     return EFI_INVALID_PARAMETER;
   }
 
+  VariableIndex = (VARIABLE_INDEX *) (UINTN) Global->VariableIndexBase;
+  if (VariableName[0] != 0 && VariableIndex != NULL && VariableIndex->Valid) {
+    return FindVariableInIndex (VariableName, VendorGuid, PtrTrack, Global, VariableIndex);
+  }
+
   InDeleteVariable = NULL;
   InDeleteIndex    = (UINTN)-1;
   InDeleteStartPtr = NULL;
@@ -1084,9 +1435,19 @@ Returns:
         return EFI_OUT_OF_RESOURCES;
       }
       //
+      // Don't rewrite the whole store through FTW if even a full reclaim
+      // can't make room for the new variable.
+      //
+      if ((UINT32) (VarSize + GetVariableStoreLiveSize (Global->NonVolatileVariableBase, Variable.CurrPtr)) >
+            ((VARIABLE_STORE_HEADER *) ((UINTN) (Global->NonVolatileVariableBase)))->Size
+            ) {
+        return EFI_OUT_OF_RESOURCES;
+      }
+      //
       // Perform garbage collection & reclaim operation
       //
       Status = Reclaim (Global->NonVolatileVariableBase, NonVolatileOffset, FALSE, Variable.CurrPtr);
+      RebuildVariableIndex (Global);
       if (EFI_ERROR (Status)) {
         return Status;
       }
@@ -1157,6 +1518,11 @@ Returns:
       return Status;
     }
 
+    AddVariableIndexEntry (
+      Global,
+      FALSE,
+      (VARIABLE_HEADER *) ((UINTN) Global->NonVolatileVariableBase + *NonVolatileOffset)
+      );
     *NonVolatileOffset = *NonVolatileOffset + VarSize;
 
   } else {
@@ -1170,6 +1536,7 @@ Returns:
       // Perform garbage collection & reclaim operation
       //
       Status = Reclaim (Global->VolatileVariableBase, VolatileOffset, TRUE, Variable.CurrPtr);
+      RebuildVariableIndex (Global);
       if (EFI_ERROR (Status)) {
         return Status;
       }
@@ -1200,6 +1567,11 @@ Returns:
       return Status;
     }
 
+    AddVariableIndexEntry (
+      Global,
+      TRUE,
+      (VARIABLE_HEADER *) ((UINTN) Global->VolatileVariableBase + *VolatileOffset)
+      );
     *VolatileOffset = *VolatileOffset + VarSize;
   }
   //
@@ -1400,6 +1772,7 @@ ReclaimForOS(
               NULL
               );
     ASSERT(!EFI_ERROR(Status));
+    RebuildVariableIndex (&mVariableModuleGlobal->VariableBase[Physical]);
   }
 
 }
@@ -1465,6 +1838,9 @@ Returns:
   if (EFI_ERROR (Status)) {
     goto Shutdown;
   }
+
+  EfiZeroMem (mVariableModuleGlobal, sizeof (ESAL_VARIABLE_GLOBAL));
+
   //
   // Allocate memory for volatile variable store
   //
@@ -1656,6 +2032,12 @@ Returns:
                NULL, 
                &ReadyToBootEvent
                );
+    if (!EFI_ERROR (Status)) {
+      //
+      // Without the index, lookups still work by walking the stores.
+      //
+      CreateVariableIndex (&mVariableModuleGlobal->VariableBase[Physical]);
+    }
   }
 
   if (EFI_ERROR (Status)) {
@@ -66,8 +66,36 @@ typedef struct {
 typedef struct {
   EFI_PHYSICAL_ADDRESS  VolatileVariableBase;
   EFI_PHYSICAL_ADDRESS  NonVolatileVariableBase;
+  EFI_PHYSICAL_ADDRESS  VariableIndexBase;
 } VARIABLE_GLOBAL;
 
+//
+// Hash index over both variable stores, keyed by (VendorGuid, Name).
+// Entries hold offsets from the store base rather than pointers, so only
+// VariableIndexBase needs converting at SetVirtualAddressMap. The index lists
+// every variable header appended to a store; the State byte is always read
+// from the store itself, so only appends and reclaims change the index.
+//
+#define VARIABLE_INDEX_BUCKETS    256
+#define VARIABLE_INDEX_END        0xFFFF
+#define VARIABLE_INDEX_MAX_COUNT  0xFFFE
+
+typedef struct {
+  UINT32  Hash;
+  UINT32  Offset;
+  UINT16  Next;
+  UINT8   Volatile;
+  UINT8   Reserved;
+} VARIABLE_INDEX_ENTRY;
+
+typedef struct {
+  BOOLEAN               Valid;
+  UINTN                 Count;
+  UINTN                 MaxCount;
+  UINT16                Bucket[VARIABLE_INDEX_BUCKETS];
+  VARIABLE_INDEX_ENTRY  Entry[1];
+} VARIABLE_INDEX;
+
 typedef struct {
   VARIABLE_GLOBAL VariableBase[2];
   UINTN           VolatileLastVariableOffset;
@@ -165,6 +165,11 @@ FtwVariableSpace (
 Routine Description:
     Write a buffer to Variable space, in the working block.
 
+    When the batched FTW protocol is available the valid variables and the
+    erased tail of the store are passed as two requests of one WriteBatch (),
+    which places them in a single spare block cycle without first copying the
+    variables into a store-sized buffer.
+
 Arguments:
     FvbHandle        - Indicates a handle to FVB to access variable store
     Buffer           - Point to the input buffer
@@ -177,13 +182,15 @@ Returns:
 
 --*/
 {
-  EFI_STATUS            Status;
-  EFI_HANDLE            FvbHandle;
-  EFI_FTW_LITE_PROTOCOL *FtwLiteProtocol;
-  EFI_LBA               VarLba;
-  UINTN                 VarOffset;
-  UINT8                 *FtwBuffer;
-  UINTN                 FtwBufferSize;
+  EFI_STATUS                  Status;
+  EFI_HANDLE                  FvbHandle;
+  EFI_FTW_LITE_PROTOCOL       *FtwLiteProtocol;
+  EFI_FTW_LITE_BATCH_PROTOCOL *FtwLiteBatchProtocol;
+  EFI_FTW_LITE_WRITE_REQUEST  Requests[2];
+  EFI_LBA                     VarLba;
+  UINTN                       VarOffset;
+  UINT8                       *FtwBuffer;
+  UINTN                       FtwBufferSize;
 
   //
   // Locate fault tolerant write protocol
@@ -196,6 +203,15 @@ Returns:
   if (EFI_ERROR (Status)) {
     return EFI_NOT_FOUND;
   }
+
+  Status = gBS->LocateProtocol (
+                  &gEfiFaultTolerantWriteLiteBatchProtocolGuid,
+                  NULL,
+                  &FtwLiteBatchProtocol
+                  );
+  if (EFI_ERROR (Status)) {
+    FtwLiteBatchProtocol = NULL;
+  }
   //
   // Locate Fvb handle by address
   //
@@ -214,7 +230,38 @@ Returns:
   // Prepare for the variable data
   //
   FtwBufferSize = ((VARIABLE_STORE_HEADER *) ((UINTN) VariableBase))->Size;
-  Status        = gBS->AllocatePool (EfiRuntimeServicesData, FtwBufferSize, &FtwBuffer);
+
+  if ((FtwLiteBatchProtocol != NULL) && (BufferSize < FtwBufferSize)) {
+    //
+    // Both requests start from VarLba, so they fall in one window and the
+    // store is still replaced atomically.
+    //
+    Status = gBS->AllocatePool (EfiRuntimeServicesData, FtwBufferSize - BufferSize, &FtwBuffer);
+    if (EFI_ERROR (Status)) {
+      return EFI_OUT_OF_RESOURCES;
+    }
+
+    EfiSetMem (FtwBuffer, FtwBufferSize - BufferSize, (UINT8) 0xff);
+
+    Requests[0].FvbHandle = FvbHandle;
+    Requests[0].Lba       = VarLba;
+    Requests[0].Offset    = VarOffset;
+    Requests[0].NumBytes  = BufferSize;
+    Requests[0].Buffer    = Buffer;
+
+    Requests[1].FvbHandle = FvbHandle;
+    Requests[1].Lba       = VarLba;
+    Requests[1].Offset    = VarOffset + BufferSize;
+    Requests[1].NumBytes  = FtwBufferSize - BufferSize;
+    Requests[1].Buffer    = FtwBuffer;
+
+    Status = FtwLiteBatchProtocol->WriteBatch (FtwLiteBatchProtocol, 2, Requests);
+
+    gBS->FreePool (FtwBuffer);
+    return Status;
+  }
+
+  Status = gBS->AllocatePool (EfiRuntimeServicesData, FtwBufferSize, &FtwBuffer);
   if (EFI_ERROR (Status)) {
     return EFI_OUT_OF_RESOURCES;
   }
@@ -34,6 +34,7 @@ Revision History
 #include EFI_ARCH_PROTOCOL_DEFINITION (Variable)
 #include EFI_PROTOCOL_DEFINITION (FirmwareVolumeBlock)
 #include EFI_PROTOCOL_DEFINITION (FaultTolerantWriteLite)
+#include EFI_PROTOCOL_DEFINITION (FaultTolerantWriteLiteBatch)
 
 //
 // Functions
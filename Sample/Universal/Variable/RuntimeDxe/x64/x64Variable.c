@@ -169,6 +169,10 @@ Returns:
     EFI_INTERNAL_POINTER,
     (VOID **) &mVariableModuleGlobal->VariableBase[Physical].VolatileVariableBase
     );
+  EfiConvertPointer (
+    EFI_OPTIONAL_POINTER,
+    (VOID **) &mVariableModuleGlobal->VariableBase[Physical].VariableIndexBase
+    );
   EfiConvertPointer (EFI_INTERNAL_POINTER, (VOID **) &mVariableModuleGlobal);
 }
 